@@ -19,6 +19,7 @@
 
 #include "canvas_painter.hpp"
 #include "views/config.hpp"
+#include "resources/resource_config.hpp"
 
 namespace fs = std::filesystem;
 
@@ -283,7 +284,7 @@ int main(int argc, char** argv)
   try
   {
     auto search_path = fs::current_path();
-    auto archive = studio::views::create_default_resource_explorer(search_path);
+    auto archive = studio::resources::create_default_resource_explorer(search_path);
     auto view_factory = studio::views::create_default_view_factory();
 
     wxApp::SetInitializerFunction(studio::createApp);
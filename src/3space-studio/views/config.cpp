@@ -11,11 +11,13 @@
 #include "resources/darkstar_volume.hpp"
 #include "resources/three_space_volume.hpp"
 #include "resources/trophy_bass_volume.hpp"
+#include "resources/zip_archive.hpp"
 
 namespace dio
 {
   namespace mis = studio::resources::mis;
   namespace vol = studio::resources::vol;
+  namespace zip = studio::resources::zip;
 }
 
 namespace studio::views
@@ -40,6 +42,23 @@ namespace studio::views
     view_factory.add_file_type(dio::vol::three_space::dyn_file_archive::is_supported, [](auto& info, auto&, auto& archive) { return std::unique_ptr<studio_view>(new vol_view(info, archive)); });
     view_factory.add_file_type(dio::vol::trophy_bass::rbx_file_archive::is_supported, [](auto& info, auto&, auto& archive) { return std::unique_ptr<studio_view>(new vol_view(info, archive)); });
     view_factory.add_file_type(dio::vol::trophy_bass::tbv_file_archive::is_supported, [](auto& info, auto&, auto& archive) { return std::unique_ptr<studio_view>(new vol_view(info, archive)); });
+    view_factory.add_file_type(dio::zip::zip_file_archive::is_supported, [](auto& info, auto&, auto& archive) { return std::unique_ptr<studio_view>(new vol_view(info, archive)); });
+
+    view_factory.add_signature(studio::resources::to_signature("PERS"), content::dts::darkstar::is_darkstar_dts);
+    view_factory.add_signature(studio::resources::to_signature("BM"), content::bmp::is_microsoft_bmp);
+    view_factory.add_signature(studio::resources::to_signature("PBMP"), content::bmp::is_phoenix_bmp);
+    view_factory.add_signature(studio::resources::to_signature("PBMA"), content::bmp::is_phoenix_bmp_array);
+    view_factory.add_signature(studio::resources::to_signature("RIFF"), content::pal::is_microsoft_pal);
+    view_factory.add_signature(studio::resources::to_signature("PL98"), content::pal::is_phoenix_pal);
+
+    view_factory.add_signatures(dio::mis::darkstar::mis_file_archive::get_signatures(), dio::mis::darkstar::mis_file_archive::is_supported);
+    view_factory.add_signatures(dio::vol::darkstar::vol_file_archive::get_signatures(), dio::vol::darkstar::vol_file_archive::is_supported);
+    view_factory.add_signatures(dio::vol::three_space::vol_file_archive::get_signatures(), dio::vol::three_space::vol_file_archive::is_supported);
+    view_factory.add_signatures(dio::vol::three_space::rmf_file_archive::get_signatures(), dio::vol::three_space::rmf_file_archive::is_supported);
+    view_factory.add_signatures(dio::vol::three_space::dyn_file_archive::get_signatures(), dio::vol::three_space::dyn_file_archive::is_supported);
+    view_factory.add_signatures(dio::vol::trophy_bass::rbx_file_archive::get_signatures(), dio::vol::trophy_bass::rbx_file_archive::is_supported);
+    view_factory.add_signatures(dio::vol::trophy_bass::tbv_file_archive::get_signatures(), dio::vol::trophy_bass::tbv_file_archive::is_supported);
+    view_factory.add_signatures(dio::zip::zip_file_archive::get_signatures(), dio::zip::zip_file_archive::is_supported);
 
     view_factory.add_extension(".dts", content::dts::darkstar::is_darkstar_dts);
 
@@ -62,30 +81,11 @@ namespace studio::views
     view_factory.add_extension(".map", dio::vol::three_space::rmf_file_archive::is_supported);
     view_factory.add_extension(".vga", dio::vol::three_space::rmf_file_archive::is_supported);
 
-    // TODO fix issues with DYN extraction
-    //view_factory.add_extension(".dyn", dio::vol::three_space::dyn_file_archive::is_supported);
+    view_factory.add_extension(".dyn", dio::vol::three_space::dyn_file_archive::is_supported);
     view_factory.add_extension(".rbx", dio::vol::trophy_bass::rbx_file_archive::is_supported);
     view_factory.add_extension(".tbv", dio::vol::trophy_bass::tbv_file_archive::is_supported);
+    view_factory.add_extension(".zip", dio::zip::zip_file_archive::is_supported);
 
     return view_factory;
   }
-
-  studio::resources::resource_explorer create_default_resource_explorer(const std::filesystem::path& search_path)
-  {
-    studio::resources::resource_explorer archive(search_path);
-
-    archive.add_archive_type(".mis", std::make_unique<dio::mis::darkstar::mis_file_archive>(), dio::mis::darkstar::mis_file_archive::supported_extensions);
-    archive.add_archive_type(".tbv", std::make_unique<dio::vol::trophy_bass::tbv_file_archive>());
-    archive.add_archive_type(".rbx", std::make_unique<dio::vol::trophy_bass::rbx_file_archive>());
-    archive.add_archive_type(".rmf", std::make_unique<dio::vol::three_space::rmf_file_archive>());
-    archive.add_archive_type(".map", std::make_unique<dio::vol::three_space::rmf_file_archive>());
-    archive.add_archive_type(".vga", std::make_unique<dio::vol::three_space::rmf_file_archive>());
-
-    // TODO fix issues with DYN extraction
-    //archive.add_archive_type(".dyn", std::make_unique<dio::vol::three_space::dyn_file_archive>());
-    archive.add_archive_type(".vol", std::make_unique<dio::vol::three_space::vol_file_archive>());
-    archive.add_archive_type(".vol", std::make_unique<dio::vol::darkstar::vol_file_archive>());
-
-    return archive;
-  }
 }
\ No newline at end of file
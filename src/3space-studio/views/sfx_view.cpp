@@ -16,13 +16,16 @@ namespace studio::views
       export_path = explorer.get_search_path() / "exported";
     }
 
-    std::basic_stringstream<std::byte> mem_buffer;
-    std::vector<std::byte> data(info.size);
-    image_stream.read(data.data(), info.size);
-
-    content::sfx::write_wav_data(mem_buffer, data);
+    // The samples are read straight in after the header, which is the only copy SFML needs.
+    {
+      studio::resources::vector_stream output(original_data);
+      content::sfx::write_wav_header(output, info.size);
+    }
 
-    original_data = mem_buffer.str();
+    const auto header_size = original_data.size();
+    original_data.resize(header_size + info.size);
+    image_stream.read(original_data.data() + header_size, std::streamsize(info.size));
+    original_data.resize(header_size + std::size_t(image_stream.gcount()));
 
     buffer.loadFromMemory(original_data.data(), original_data.size());
     sound.setBuffer(buffer);
@@ -79,9 +82,16 @@ namespace studio::views
 
       std::for_each(std::execution::par_unseq, files.begin(), files.end(), [=](const auto& snd_info) {
         auto archive_path = studio::resources::resource_explorer::get_archive_path(snd_info.folder_path);
-        auto sound_stream = explorer.load_file(snd_info);
+        auto sound = explorer.load_file_view(snd_info);
+
+        if (!sound.has_value())
+        {
+          return;
+        }
+
+        auto sound_stream = sound->open();
 
-        if (content::sfx::is_sfx_file(*sound_stream.second))
+        if (content::sfx::is_sfx_file(*sound_stream))
         {
           auto final_folder = export_path /std::filesystem::relative(snd_info.folder_path, archive_path);
           std::filesystem::create_directories(final_folder);
@@ -89,10 +99,8 @@ namespace studio::views
 
           std::basic_ofstream<std::byte> output(new_file_name, std::ios::binary);
 
-          content::sfx::write_wav_header(output, snd_info.size);
-          std::copy_n(std::istreambuf_iterator<std::byte>(*sound_stream.second),
-                      snd_info.size,
-                      std::ostreambuf_iterator<std::byte>(output));
+          content::sfx::write_wav_header(output, sound->data.size());
+          output.write(sound->data.data(), std::streamsize(sound->data.size()));
         }
       });
     }
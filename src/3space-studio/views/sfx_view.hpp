@@ -20,7 +20,7 @@ namespace studio::views
     static std::filesystem::path export_path;
     const studio::resources::resource_explorer& explorer;
     studio::resources::file_info info;
-    std::basic_string<std::byte> original_data;
+    std::vector<std::byte> original_data;
     sf::SoundBuffer buffer;
     sf::Sound sound;
     bool opened_folder = false;
@@ -1,6 +1,7 @@
 #include "view_factory.hpp"
 #include "vol_view.hpp"
 #include "content/dts/darkstar.hpp"
+#include "resources/memory_stream.hpp"
 
 namespace studio::views
 {
@@ -19,6 +20,24 @@ namespace studio::views
     validators.emplace(*extensions.emplace(extension).first, checker);
   }
 
+  void view_factory::add_signature(studio::resources::file_signature signature, stream_validator* checker)
+  {
+    signatures.add(signature, checker);
+  }
+
+  void view_factory::add_signatures(const std::vector<studio::resources::file_signature>& new_signatures, stream_validator* checker)
+  {
+    for (auto signature : new_signatures)
+    {
+      signatures.add(signature, checker);
+    }
+  }
+
+  bool view_factory::is_candidate(stream_validator* checker, const std::vector<stream_validator*>& candidates) const
+  {
+    return !signatures.contains(checker) || std::find(candidates.begin(), candidates.end(), checker) != candidates.end();
+  }
+
   [[nodiscard]] std::vector<std::string_view> view_factory::get_extensions() const
   {
     return std::vector<std::string_view>(extensions.cbegin(), extensions.cend());
@@ -26,26 +45,42 @@ namespace studio::views
 
   std::unique_ptr<studio_view> view_factory::create_view(const studio::resources::file_info& file_info, std::basic_istream<std::byte>& stream, const studio::resources::resource_explorer& manager) const
   {
+    // The start of the file is read once. Validators only look at that copy, and only when their signature matches it.
+    studio::resources::file_header header{};
+    const auto header_data = nonstd::span<const std::byte>(header.data(), studio::resources::read_file_header(stream, header));
+    const auto candidates = signatures.find(header_data);
+
+    auto is_valid = [&](stream_validator* checker) {
+      if (!is_candidate(checker, candidates))
+      {
+        return false;
+      }
+
+      studio::resources::memory_stream header_stream(header_data);
+      return checker(header_stream);
+    };
+
     auto archive_type = validators.equal_range(shared::to_lower(file_info.filename.extension().string()));
 
     for (auto it = archive_type.first; it != archive_type.second; ++it)
     {
-      if (it->second(stream))
+      if (is_valid(it->second))
       {
         return creators.at(it->second)(file_info, stream, manager);
       }
     }
 
-    for (auto& [checker, creator] : creators)
+    // Without a matching extension, only formats which can be told apart by their signature are considered.
+    for (auto checker : candidates)
     {
-      if (auto allowed = no_fallback_allowed.find(checker); allowed != no_fallback_allowed.end())
+      if (no_fallback_allowed.find(checker) != no_fallback_allowed.end())
       {
-        return std::make_unique<default_view>(file_info);
+        continue;
       }
 
-      if (checker(stream))
+      if (auto creator = creators.find(checker); creator != creators.end() && is_valid(checker))
       {
-        return creator(file_info, stream, manager);
+        return creator->second(file_info, stream, manager);
       }
     }
 
@@ -6,6 +6,7 @@
 #include "graphics_view.hpp"
 #include "default_view.hpp"
 #include "resources/resource_explorer.hpp"
+#include "resources/signature_registry.hpp"
 #include "3space-studio/utility.hpp"
 
 namespace studio::views
@@ -21,6 +22,10 @@ namespace studio::views
 
     void add_extension(std::string_view extension, stream_validator* checker);
 
+    void add_signature(studio::resources::file_signature signature, stream_validator* checker);
+
+    void add_signatures(const std::vector<studio::resources::file_signature>& signatures, stream_validator* checker);
+
     [[nodiscard]] std::vector<std::string_view> get_extensions() const;
 
     std::unique_ptr<studio_view> create_view(const studio::resources::file_info& file_info, std::basic_istream<std::byte>& stream, const studio::resources::resource_explorer& manager) const;
@@ -28,10 +33,13 @@ namespace studio::views
     std::unique_ptr<studio_view> create_default_view(const studio::resources::file_info& file_info, std::basic_istream<std::byte>& stream, const studio::resources::resource_explorer& manager) const;
 
   private:
+    bool is_candidate(stream_validator* checker, const std::vector<stream_validator*>& candidates) const;
+
     std::set<std::string> extensions;
     std::set<stream_validator*> no_fallback_allowed;
     std::map<stream_validator*, view_creator*> creators;
     std::multimap<std::string_view, stream_validator*> validators;
+    studio::resources::signature_registry<stream_validator*> signatures;
   };
 }// namespace studio::views
 
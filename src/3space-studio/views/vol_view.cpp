@@ -1,10 +1,12 @@
 #include <utility>
 #include <execution>
 #include <atomic>
+#include <iterator>
 #include <wx/treelist.h>
 #include <wx/filepicker.h>
 
 #include "vol_view.hpp"
+#include "resources/bulk_extractor.hpp"
 #include "3space-studio/utility.hpp"
 
 namespace studio::views
@@ -14,6 +16,13 @@ namespace studio::views
   {
     archive_path = info.folder_path / info.filename;
     files = archive.find_files(archive_path, { "ALL" });
+
+    file_indexes.reserve(files.size());
+
+    for (auto i = 0u; i < files.size(); ++i)
+    {
+      file_indexes.emplace((files[i].folder_path / files[i].filename).lexically_normal().u8string(), i);
+    }
   }
 
   void vol_view::setup_view(wxWindow& parent)
@@ -22,7 +31,8 @@ namespace studio::views
       { studio::resources::compression_type::none, "None" },
       { studio::resources::compression_type::lz, "Lempel-Ziv" },
       { studio::resources::compression_type::lzh, "Lempel-Ziv w/ Huffman coding" },
-      { studio::resources::compression_type::rle, "Run-Length Encoding" }
+      { studio::resources::compression_type::rle, "Run-Length Encoding" },
+      { studio::resources::compression_type::deflate, "Deflate" }
     };
 
     std::set<std::filesystem::path> folders;
@@ -52,13 +62,11 @@ namespace studio::views
           path = path / table->GetItemText(id, table->GetColumnCount() - 3).c_str().AsChar();
         }
 
-        auto original_info = std::find_if(files.begin(), files.end(), [&](auto& info) {
-          return info.folder_path == path && info.filename == table->GetItemText(id, 0).c_str().AsChar();
-        });
+        path = path / table->GetItemText(id, 0).c_str().AsChar();
 
-        if (original_info != files.end())
+        if (auto original_info = file_indexes.find(path.lexically_normal().u8string()); original_info != file_indexes.end())
         {
-          archive.execute_action("open_new_tab", *original_info);
+          archive.execute_action("open_new_tab", files[original_info->second]);
         }
       });
 
@@ -114,19 +122,26 @@ namespace studio::views
         scoped_dialog->Show();
         text1->SetLabel("Extracting to\n" + (dest / archive_path.stem()).string());
 
-        std::basic_ifstream<std::byte> archive_file(archive_path, std::ios::binary);
+        studio::resources::bulk_extractor extractor(archive);
+
+        extractor.set_progress_callback([&](const auto& file) {
+          static std::mutex progress_mutex;
+          std::lock_guard<std::mutex> lock(progress_mutex);
 
-        for (auto& file : files)
-        {
           if (should_cancel)
           {
-            return true;
+            extractor.cancel();
           }
 
           text2->SetLabel((std::filesystem::relative(file.folder_path, archive_path) / file.filename).string());
-
-          archive.extract_file_contents(archive_file, dest, file);
           gauge->SetValue(gauge->GetValue() + 1);
+        });
+
+        extractor.extract(files, dest);
+
+        if (should_cancel)
+        {
+          return true;
         }
 
         if (!opened_folder)
@@ -193,35 +208,30 @@ namespace studio::views
           return std::make_pair(file_archive_path, std::move(child_files));
         });
 
-        std::for_each(std::execution::par_unseq, found_files.begin(), found_files.end(), [=](const auto& info) {
-          static std::mutex label_mutex;
-          static std::mutex gauge_mutex;
+        std::vector<studio::resources::file_info> entries;
+
+        for (auto& [file_archive_path, child_files] : found_files)
+        {
+          std::move(child_files.begin(), child_files.end(), std::back_inserter(entries));
+        }
 
-          const auto& [file_archive_path, child_files] = info;
+        studio::resources::bulk_extractor extractor(archive);
 
-          std::basic_ifstream<std::byte> archive_file(file_archive_path, std::ios::binary);
+        extractor.set_progress_callback([&](const auto& file) {
+          static std::mutex progress_mutex;
+          std::lock_guard<std::mutex> lock(progress_mutex);
 
-          for (const auto& file : child_files)
+          if (should_cancel)
           {
-            if (should_cancel)
-            {
-              return;
-            }
-
-            {
-              std::lock_guard<std::mutex> lock(label_mutex);
-              text2->SetLabel((std::filesystem::relative(file.folder_path, archive.get_search_path()) / file.filename).string());
-            }
-
-            archive.extract_file_contents(archive_file, dest, file);
-
-            {
-              std::lock_guard<std::mutex> lock(gauge_mutex);
-              gauge->SetValue(gauge->GetValue() + 1);
-            }
+            extractor.cancel();
           }
+
+          text2->SetLabel((std::filesystem::relative(file.folder_path, archive.get_search_path()) / file.filename).string());
+          gauge->SetValue(gauge->GetValue() + 1);
         });
 
+        extractor.extract(entries, dest);
+
         if (!opened_folder)
         {
           wxLaunchDefaultApplication(dest.string());
@@ -2,6 +2,7 @@
 #define DARKSTARDTSCONVERTER_VOL_VIEW_HPP
 
 #include <future>
+#include <unordered_map>
 #include "graphics_view.hpp"
 #include "resources/resource_explorer.hpp"
 
@@ -17,6 +18,7 @@ namespace studio::views
     const studio::resources::resource_explorer& archive;
     std::filesystem::path archive_path;
     std::vector<studio::resources::file_info> files;
+    std::unordered_map<std::string, std::size_t> file_indexes;
     std::future<bool> pending_save;
     bool should_cancel;
     bool opened_folder = false;
@@ -316,6 +316,16 @@ namespace studio::resources::mis::darkstar
     return is_mission_data(stream);
   }
 
+  std::vector<studio::resources::file_signature> mis_file_archive::get_signatures()
+  {
+    return { sim_group_tag };
+  }
+
+  std::vector<studio::resources::file_signature> mis_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
   std::filesystem::path get_archive_path(const std::filesystem::path& archive_or_folder_path)
   {
     auto archive_path = archive_or_folder_path;
@@ -430,6 +440,7 @@ namespace studio::resources::mis::darkstar
 
   std::vector<mis_file_archive::content_info> mis_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
   {
+    std::lock_guard<std::mutex> lock(cache_mutex);
     auto existing_info = cache_data(stream, archive_or_folder_path);
     std::vector<mis_file_archive::content_info> final_results;
     final_results.reserve(existing_info->second.size());
@@ -469,6 +480,8 @@ namespace studio::resources::mis::darkstar
   void mis_file_archive::extract_file_contents(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const
   {
     set_stream_position(stream, info);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
     auto existing_info = cache_data(stream, info.folder_path);
 
     for (auto& ref : existing_info->second)
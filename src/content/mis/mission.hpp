@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <istream>
 #include <variant>
@@ -199,11 +200,16 @@ namespace studio::resources::mis::darkstar
     mutable std::map<std::filesystem::path, ::studio::mis::darkstar::sim_items> contents;
     mutable std::map<std::filesystem::path, ref_vector> content_list_info;
 
-    decltype(content_list_info)::iterator mis_file_archive::cache_data(std::basic_istream<std::byte>& stream, const std::filesystem::path& archive_or_folder_path) const;
+    // Archives can be listed from several threads at once, while the parsed data is shared.
+    mutable std::mutex cache_mutex;
+
+    decltype(content_list_info)::iterator cache_data(std::basic_istream<std::byte>& stream, const std::filesystem::path& archive_or_folder_path) const;
 
     static bool is_supported(std::basic_istream<std::byte>& stream);
+    static std::vector<studio::resources::file_signature> get_signatures();
 
     bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
     std::vector<content_info> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
     void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
     void extract_file_contents(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const override;
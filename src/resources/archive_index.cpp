@@ -0,0 +1,169 @@
+#include <stdexcept>
+#include "resources/archive_index.hpp"
+
+namespace studio::resources
+{
+  archive_index::archive_index(const std::vector<content_info>& listing)
+  {
+    reserve(listing.size());
+
+    for (const auto& item : listing)
+    {
+      add(item);
+    }
+  }
+
+  void archive_index::reserve(std::size_t count)
+  {
+    kinds.reserve(count);
+    name_offsets.reserve(count);
+    name_sizes.reserve(count);
+    entry_path_ids.reserve(count);
+    offsets.reserve(count);
+    sizes.reserve(count);
+    compression_types.reserve(count);
+  }
+
+  std::uint32_t archive_index::add_path(const std::filesystem::path& path)
+  {
+    auto [existing, added] = path_ids.emplace(path.u8string(), std::uint32_t(paths.size()));
+
+    if (added)
+    {
+      paths.emplace_back(path);
+    }
+
+    return existing->second;
+  }
+
+  void archive_index::add_file(std::string_view filename, std::uint32_t folder_path_id, std::uint64_t offset, std::uint64_t size, studio::resources::compression_type compression_type)
+  {
+    if (folder_path_id >= paths.size())
+    {
+      throw std::invalid_argument("The folder of an archive entry has not been added to the index.");
+    }
+
+    kinds.emplace_back(entry_kind::file);
+    name_offsets.emplace_back(std::uint32_t(names.size()));
+    name_sizes.emplace_back(std::uint32_t(filename.size()));
+    names.append(filename);
+    entry_path_ids.emplace_back(folder_path_id);
+    offsets.emplace_back(offset);
+    sizes.emplace_back(size);
+    compression_types.emplace_back(compression_type);
+  }
+
+  void archive_index::add_folder(std::string_view name, std::uint32_t full_path_id, std::optional<std::uint64_t> file_count)
+  {
+    if (full_path_id >= paths.size())
+    {
+      throw std::invalid_argument("The path of an archive folder has not been added to the index.");
+    }
+
+    kinds.emplace_back(file_count.has_value() ? entry_kind::counted_folder : entry_kind::folder);
+    name_offsets.emplace_back(std::uint32_t(names.size()));
+    name_sizes.emplace_back(std::uint32_t(name.size()));
+    names.append(name);
+    entry_path_ids.emplace_back(full_path_id);
+    offsets.emplace_back(0);
+    sizes.emplace_back(file_count.value_or(0));
+    compression_types.emplace_back(studio::resources::compression_type::none);
+  }
+
+  void archive_index::add(const content_info& item)
+  {
+    std::visit([&](const auto& info) {
+      using T = std::decay_t<decltype(info)>;
+
+      if constexpr (std::is_same_v<T, studio::resources::folder_info>)
+      {
+        add_folder(info.name, add_path(info.full_path), info.file_count);
+      }
+      else
+      {
+        add_file(info.filename.u8string(), add_path(info.folder_path), info.offset, info.size, info.compression_type);
+      }
+    },
+      item);
+  }
+
+  std::size_t archive_index::size() const
+  {
+    return kinds.size();
+  }
+
+  archive_index::entry_kind archive_index::get_kind(std::size_t index) const
+  {
+    return kinds[index];
+  }
+
+  std::string_view archive_index::get_name(std::size_t index) const
+  {
+    return std::string_view(names).substr(name_offsets[index], name_sizes[index]);
+  }
+
+  std::uint32_t archive_index::get_path_id(std::size_t index) const
+  {
+    return entry_path_ids[index];
+  }
+
+  std::uint64_t archive_index::get_offset(std::size_t index) const
+  {
+    return offsets[index];
+  }
+
+  std::uint64_t archive_index::get_size(std::size_t index) const
+  {
+    return sizes[index];
+  }
+
+  studio::resources::compression_type archive_index::get_compression_type(std::size_t index) const
+  {
+    return compression_types[index];
+  }
+
+  const std::vector<std::filesystem::path>& archive_index::get_paths() const
+  {
+    return paths;
+  }
+
+  archive_index::content_info archive_index::get(std::size_t index) const
+  {
+    const auto name = get_name(index);
+
+    if (kinds[index] == entry_kind::file)
+    {
+      studio::resources::file_info info{};
+      info.filename = std::filesystem::u8path(name.begin(), name.end());
+      info.folder_path = paths[entry_path_ids[index]];
+      info.offset = offsets[index];
+      info.size = sizes[index];
+      info.compression_type = compression_types[index];
+      return info;
+    }
+
+    studio::resources::folder_info info{};
+    info.name = std::string(name);
+    info.full_path = paths[entry_path_ids[index]];
+
+    if (kinds[index] == entry_kind::counted_folder)
+    {
+      info.file_count = sizes[index];
+    }
+
+    return info;
+  }
+
+  std::vector<archive_index::content_info> archive_index::get_listing() const
+  {
+    std::vector<content_info> results;
+    results.reserve(size());
+
+    for (auto i = 0u; i < size(); ++i)
+    {
+      results.emplace_back(get(i));
+    }
+
+    return results;
+  }
+}// namespace studio::resources
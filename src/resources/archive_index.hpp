@@ -0,0 +1,79 @@
+#ifndef DARKSTARDTSCONVERTER_ARCHIVE_INDEX_HPP
+#define DARKSTARDTSCONVERTER_ARCHIVE_INDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include "archive_plugin.hpp"
+
+namespace studio::resources
+{
+  // A listing of an archive stored as parallel arrays.
+  // All names share one buffer, each folder path is only stored once, and a file_info or folder_info
+  // is only created when an entry is asked for.
+  class archive_index
+  {
+  public:
+    using content_info = studio::resources::archive_plugin::content_info;
+
+    enum class entry_kind : std::uint8_t
+    {
+      file,
+      folder,
+      counted_folder
+    };
+
+    archive_index() = default;
+    explicit archive_index(const std::vector<content_info>& listing);
+
+    void reserve(std::size_t count);
+
+    std::uint32_t add_path(const std::filesystem::path& path);
+
+    void add_file(std::string_view filename, std::uint32_t folder_path_id, std::uint64_t offset, std::uint64_t size, studio::resources::compression_type compression_type);
+
+    void add_folder(std::string_view name, std::uint32_t full_path_id, std::optional<std::uint64_t> file_count);
+
+    void add(const content_info& item);
+
+    std::size_t size() const;
+
+    entry_kind get_kind(std::size_t index) const;
+
+    std::string_view get_name(std::size_t index) const;
+
+    // The folder of a file, or the full path of a folder.
+    std::uint32_t get_path_id(std::size_t index) const;
+
+    std::uint64_t get_offset(std::size_t index) const;
+
+    // The size of a file, or the file count of a folder.
+    std::uint64_t get_size(std::size_t index) const;
+
+    studio::resources::compression_type get_compression_type(std::size_t index) const;
+
+    const std::vector<std::filesystem::path>& get_paths() const;
+
+    content_info get(std::size_t index) const;
+
+    std::vector<content_info> get_listing() const;
+
+  private:
+    std::string names;
+    std::vector<std::filesystem::path> paths;
+    std::unordered_map<std::string, std::uint32_t> path_ids;
+
+    std::vector<entry_kind> kinds;
+    std::vector<std::uint32_t> name_offsets;
+    std::vector<std::uint32_t> name_sizes;
+    std::vector<std::uint32_t> entry_path_ids;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> sizes;
+    std::vector<studio::resources::compression_type> compression_types;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_ARCHIVE_INDEX_HPP
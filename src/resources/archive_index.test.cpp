@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+#include "archive_index.hpp"
+
+TEST_CASE("Archive listings survive being stored as an index", "[resources]")
+{
+  studio::resources::file_info first{};
+  first.filename = "first.dts";
+  first.folder_path = "/game/shapes.vol";
+  first.offset = 16;
+  first.size = 1024;
+  first.compression_type = studio::resources::compression_type::lzh;
+
+  auto second = first;
+  second.filename = "second.dts";
+  second.offset = 1040;
+
+  studio::resources::folder_info folder{};
+  folder.name = "group";
+  folder.full_path = "/game/shapes.vol/group";
+  folder.file_count = 3;
+
+  const std::vector<studio::resources::archive_index::content_info> listing{ first, folder, second };
+
+  studio::resources::archive_index index(listing);
+
+  REQUIRE(index.size() == 3);
+  REQUIRE(index.get_paths().size() == 2);
+  REQUIRE(index.get_name(2) == "second.dts");
+
+  const auto result = index.get_listing();
+  REQUIRE(result.size() == 3);
+
+  const auto& restored = std::get<studio::resources::file_info>(result[2]);
+  REQUIRE(restored.filename == second.filename);
+  REQUIRE(restored.folder_path == second.folder_path);
+  REQUIRE(restored.offset == second.offset);
+  REQUIRE(restored.size == second.size);
+  REQUIRE(restored.compression_type == second.compression_type);
+
+  const auto& restored_folder = std::get<studio::resources::folder_info>(result[1]);
+  REQUIRE(restored_folder.name == folder.name);
+  REQUIRE(restored_folder.full_path == folder.full_path);
+  REQUIRE(restored_folder.file_count == folder.file_count);
+}
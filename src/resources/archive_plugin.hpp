@@ -4,10 +4,12 @@
 #include <istream>
 #include <ostream>
 #include <string>
+#include <memory>
 #include <optional>
 #include <variant>
 #include <filesystem>
 #include "../shared.hpp"
+#include "signature_registry.hpp"
 
 namespace studio::resources
 {
@@ -16,7 +18,8 @@ namespace studio::resources
     none,
     rle,
     lz,
-    lzh
+    lzh,
+    deflate
   };
 
   struct file_info
@@ -43,12 +46,33 @@ namespace studio::resources
 
     virtual bool stream_is_supported(std::basic_istream<std::byte>&) const = 0;
 
+    // The magic bytes which files supported by the plugin start with.
+    // Plugins without any are checked against every file with a matching extension.
+    virtual std::vector<file_signature> stream_signatures() const
+    {
+      return {};
+    }
+
     virtual std::vector<content_info> get_content_listing(std::basic_istream<std::byte>&, std::filesystem::path) const = 0;
 
+    // The file which holds the data of an entry, which set_stream_position positions a stream of.
+    // Most archives hold their own data, but some are only an index of data kept in other files next to them.
+    virtual std::filesystem::path get_data_path(const std::filesystem::path& archive_path, const file_info&) const
+    {
+      return archive_path;
+    }
+
     virtual void set_stream_position(std::basic_istream<std::byte>&, const file_info&) const = 0;
 
     virtual void extract_file_contents(std::basic_istream<std::byte>&, const file_info&, std::basic_ostream<std::byte>&) const = 0;
 
+    // Opens a compressed entry so that only the parts which are read get decoded. The entry keeps the archive stream alive.
+    // Plugins which can't do that return nothing, and the entry is decoded in full with extract_file_contents instead.
+    virtual std::unique_ptr<std::basic_istream<std::byte>> open_compressed_entry(std::unique_ptr<std::basic_istream<std::byte>>, const file_info&) const
+    {
+      return nullptr;
+    }
+
     virtual ~archive_plugin() = default;
     archive_plugin() = default;
     archive_plugin(const archive_plugin&) = delete;
@@ -0,0 +1,52 @@
+#ifndef DARKSTARDTSCONVERTER_BLOOM_FILTER_HPP
+#define DARKSTARDTSCONVERTER_BLOOM_FILTER_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace studio::resources
+{
+  // Answers "definitely not present" without touching the real index.
+  // Each item sets a few bits picked by double hashing a single hash value.
+  class bloom_filter
+  {
+  public:
+    explicit bloom_filter(std::size_t expected_count = 0, std::size_t bits_per_item = 10)
+      : bits(std::max<std::size_t>((expected_count * bits_per_item + 63) / 64, 1))
+    {
+    }
+
+    void add(std::uint64_t hash)
+    {
+      for_each_bit(hash, [this](std::size_t bit) { bits[bit / 64] |= std::uint64_t(1) << (bit % 64); });
+    }
+
+    bool might_contain(std::uint64_t hash) const
+    {
+      auto result = true;
+      for_each_bit(hash, [&](std::size_t bit) { result = result && (bits[bit / 64] & (std::uint64_t(1) << (bit % 64))); });
+      return result;
+    }
+
+  private:
+    constexpr static std::size_t hash_count = 6;
+
+    template<typename Callback>
+    void for_each_bit(std::uint64_t hash, Callback&& callback) const
+    {
+      const auto bit_count = bits.size() * 64;
+      const auto second_hash = ((hash * 0x9e3779b97f4a7c15ull) >> 32) | 1;
+
+      for (auto i = 0u; i < hash_count; ++i)
+      {
+        callback(std::size_t((hash + i * second_hash) % bit_count));
+      }
+    }
+
+    std::vector<std::uint64_t> bits;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_BLOOM_FILTER_HPP
@@ -0,0 +1,65 @@
+#ifndef DARKSTARDTSCONVERTER_BOUNDED_READER_HPP
+#define DARKSTARDTSCONVERTER_BOUNDED_READER_HPP
+
+#include <array>
+#include <cstddef>
+#include <istream>
+#include <cstdint>
+
+namespace studio::resources
+{
+  // Reads at most "limit" bytes from a stream in large chunks,
+  // so that decoders can pull single bytes without going through the stream each time.
+  class bounded_reader
+  {
+  public:
+    bounded_reader(std::basic_istream<std::byte>& stream, std::size_t limit)
+      : stream(stream), remaining(limit)
+    {
+    }
+
+    // Returns the next byte, or -1 once the limit or the end of the stream has been reached.
+    int get()
+    {
+      if (position == end && !refill())
+      {
+        return -1;
+      }
+
+      total_consumed++;
+      return std::to_integer<int>(buffer[position++]);
+    }
+
+    std::size_t consumed() const
+    {
+      return total_consumed;
+    }
+
+  private:
+    bool refill()
+    {
+      if (remaining == 0 || !stream.good())
+      {
+        return false;
+      }
+
+      stream.read(buffer.data(), std::streamsize(remaining < buffer.size() ? remaining : buffer.size()));
+      const auto count = std::size_t(stream.gcount());
+
+      remaining -= count;
+      position = 0;
+      end = count;
+
+      return count > 0;
+    }
+
+    std::basic_istream<std::byte>& stream;
+    std::size_t remaining;
+    std::size_t total_consumed = 0;
+    std::size_t position = 0;
+    std::size_t end = 0;
+    std::array<std::byte, 16384> buffer{};
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_BOUNDED_READER_HPP
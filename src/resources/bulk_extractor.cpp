@@ -0,0 +1,249 @@
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include "resources/bulk_extractor.hpp"
+#include "resources/memory_stream.hpp"
+
+namespace studio::resources
+{
+  namespace
+  {
+    constexpr std::size_t decode_slice_size = 16 * 1024 * 1024;
+
+    // Stored entries are limited by the disk rather than by decoding, so volumes with only those are still read by one task.
+    std::vector<std::vector<studio::resources::file_info>> split_volume(std::vector<studio::resources::file_info> entries)
+    {
+      const auto has_compressed_entries = std::any_of(entries.begin(), entries.end(), [](const auto& entry) {
+        return entry.compression_type != studio::resources::compression_type::none;
+      });
+
+      if (!has_compressed_entries)
+      {
+        return { std::move(entries) };
+      }
+
+      std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.offset < b.offset;
+      });
+
+      std::vector<std::vector<studio::resources::file_info>> results;
+      std::size_t slice_bytes = 0;
+
+      for (auto& entry : entries)
+      {
+        if (results.empty() || slice_bytes >= decode_slice_size)
+        {
+          results.emplace_back();
+          slice_bytes = 0;
+        }
+
+        slice_bytes += entry.size;
+        results.back().emplace_back(std::move(entry));
+      }
+
+      return results;
+    }
+  }// namespace
+
+  bulk_extractor::bulk_extractor(const studio::resources::resource_explorer& explorer, std::size_t max_in_flight_bytes, studio::resources::task_pool& pool)
+    : explorer(explorer), pool(pool), budget(std::max<std::size_t>(max_in_flight_bytes, 1))
+  {
+  }
+
+  void bulk_extractor::set_progress_callback(std::function<void(const studio::resources::file_info&)> callback)
+  {
+    progress = std::move(callback);
+  }
+
+  void bulk_extractor::cancel()
+  {
+    cancelled = true;
+  }
+
+  bulk_extractor::statistics bulk_extractor::extract(const std::vector<studio::resources::file_info>& entries, const std::filesystem::path& destination)
+  {
+    cancelled = false;
+    files_written = 0;
+    bytes_written = 0;
+    failures.clear();
+
+    auto volumes = studio::resources::resource_explorer::group_by_archive(entries);
+
+    // Writers are declared first so that they outlive the readers which queue them.
+    studio::resources::task_group writers(pool);
+    studio::resources::task_group readers(pool);
+
+    std::vector<std::pair<std::filesystem::path, std::vector<studio::resources::file_info>>> slices;
+
+    for (auto& volume : volumes)
+    {
+      for (auto& slice : split_volume(std::move(volume.second)))
+      {
+        slices.emplace_back(volume.first, std::move(slice));
+      }
+    }
+
+    for (auto& slice : slices)
+    {
+      readers.run([this, &slice, &destination, &writers] {
+        try
+        {
+          extract_volume(slice.first, std::move(slice.second), destination, writers);
+        }
+        catch (const std::exception& error)
+        {
+          add_failure(slice.first, error.what());
+        }
+      });
+    }
+
+    readers.wait();
+    writers.wait();
+
+    return { files_written, bytes_written, std::move(failures) };
+  }
+
+  void bulk_extractor::extract_volume(const std::filesystem::path& archive_path,
+    std::vector<studio::resources::file_info> entries,
+    const std::filesystem::path& destination,
+    studio::resources::task_group& writers)
+  {
+    auto archive = explorer.get_archive_type(archive_path);
+
+    if (!archive.has_value())
+    {
+      add_failure(archive_path, "is not a supported archive");
+      return;
+    }
+
+    // Folders are resolved and created up front, so that writers only ever have to open files.
+    // Other parts of the same volume can be creating the same folders at the same time, so errors are left to the writers to report.
+    std::unordered_map<std::string, std::filesystem::path> folders;
+
+    for (const auto& entry : entries)
+    {
+      auto key = entry.folder_path.u8string();
+
+      if (folders.find(key) == folders.end())
+      {
+        auto folder = explorer.get_extraction_folder(destination, entry);
+        std::error_code error;
+        std::filesystem::create_directories(folder, error);
+        folders.emplace(std::move(key), std::move(folder));
+      }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+      return a.offset < b.offset;
+    });
+
+    auto archive_file = explorer.load_file(archive_path);
+
+    for (const auto& entry : entries)
+    {
+      if (cancelled)
+      {
+        return;
+      }
+
+      // The listed size is reserved before decoding, so that the entry never sits in memory outside of the budget.
+      auto reserved = budget.acquire(entry.size, writers);
+
+      auto data = std::make_shared<std::vector<std::byte>>();
+      data->reserve(entry.size);
+
+      // A damaged entry is reported on its own, and the rest of the volume is still extracted.
+      try
+      {
+        studio::resources::vector_stream output(*data);
+        archive->get().extract_file_contents(*archive_file.second, entry, output);
+      }
+      catch (const std::exception& error)
+      {
+        budget.release(reserved);
+        add_failure(entry.folder_path / entry.filename, error.what());
+        archive_file.second->clear();
+        continue;
+      }
+
+      if (data->size() < reserved)
+      {
+        budget.release(reserved - data->size());
+        reserved = data->size();
+      }
+
+      writers.run([this, data, reserved, entry, file_path = folders.at(entry.folder_path.u8string()) / entry.filename] {
+        auto written = false;
+
+        try
+        {
+          std::ofstream new_file(file_path, std::ios::binary);
+          new_file.write(reinterpret_cast<const char*>(data->data()), std::streamsize(data->size()));
+          written = bool(new_file);
+        }
+        catch (const std::exception&)
+        {
+        }
+
+        budget.release(reserved);
+
+        if (!written)
+        {
+          add_failure(file_path, "could not be written");
+          return;
+        }
+
+        files_written++;
+        bytes_written += data->size();
+
+        if (progress)
+        {
+          progress(entry);
+        }
+      });
+    }
+  }
+
+  void bulk_extractor::add_failure(const std::filesystem::path& path, std::string message)
+  {
+    std::lock_guard<std::mutex> lock(failure_mutex);
+    failures.push_back({ path, std::move(message) });
+  }
+
+  std::size_t bulk_extractor::byte_budget::acquire(std::size_t bytes, studio::resources::task_group& writers)
+  {
+    bytes = std::min(bytes, limit);
+
+    while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (used + bytes <= limit)
+        {
+          used += bytes;
+          return bytes;
+        }
+      }
+
+      if (writers.run_one())
+      {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex);
+      released.wait_for(lock, std::chrono::milliseconds(1), [&] { return used + bytes <= limit; });
+    }
+  }
+
+  void bulk_extractor::byte_budget::release(std::size_t bytes)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      used -= bytes;
+    }
+
+    released.notify_all();
+  }
+}// namespace studio::resources
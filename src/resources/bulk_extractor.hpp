@@ -0,0 +1,98 @@
+#ifndef DARKSTARDTSCONVERTER_BULK_EXTRACTOR_HPP
+#define DARKSTARDTSCONVERTER_BULK_EXTRACTOR_HPP
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <condition_variable>
+#include "resource_explorer.hpp"
+#include "task_pool.hpp"
+
+namespace studio::resources
+{
+  // Extracts many archive entries at once, to the same folders as resource_explorer::extract_file_contents.
+  // Each volume is read by a single task in offset order, so reads stay sequential, while decoded entries are
+  // written out by other tasks. Volumes are extracted in parallel with each other, and volumes with compressed
+  // entries are also split into runs of neighbouring entries, so that decoding a single large volume isn't limited to one thread.
+  // Entries being decoded or waiting to be written are limited to a budget in bytes, which makes readers wait for writers
+  // instead of growing memory use when the disk is the slowest part.
+  class bulk_extractor
+  {
+  public:
+    constexpr static std::size_t default_in_flight_budget = 64 * 1024 * 1024;
+
+    struct failure
+    {
+      std::filesystem::path path;
+      std::string message;
+    };
+
+    struct statistics
+    {
+      std::size_t files_written;
+      std::uint64_t bytes_written;
+      std::vector<failure> failures;
+    };
+
+    explicit bulk_extractor(const studio::resources::resource_explorer& explorer,
+      std::size_t max_in_flight_bytes = default_in_flight_budget,
+      studio::resources::task_pool& pool = studio::resources::task_pool::shared());
+
+    // Called from worker threads after each entry has been written.
+    void set_progress_callback(std::function<void(const studio::resources::file_info&)> callback);
+
+    // Stops reading new entries. Entries which have already been read are still written.
+    void cancel();
+
+    // A volume or file which cannot be extracted is reported as a failure, without stopping the others.
+    statistics extract(const std::vector<studio::resources::file_info>& entries, const std::filesystem::path& destination);
+
+  private:
+    // Counts the bytes which are being read or have been read but not written yet.
+    class byte_budget
+    {
+    public:
+      explicit byte_budget(std::size_t limit) : limit(limit) {}
+
+      // Waits until the bytes fit, running queued writers in the meantime so that they can make progress.
+      // Only writers are run, since another reader would only add to what is waiting on the budget.
+      // Requests larger than the limit are let through on their own.
+      std::size_t acquire(std::size_t bytes, studio::resources::task_group& writers);
+
+      void release(std::size_t bytes);
+
+    private:
+      std::mutex mutex;
+      std::condition_variable released;
+      std::size_t limit;
+      std::size_t used = 0;
+    };
+
+    void extract_volume(const std::filesystem::path& archive_path,
+      std::vector<studio::resources::file_info> entries,
+      const std::filesystem::path& destination,
+      studio::resources::task_group& writers);
+
+    void add_failure(const std::filesystem::path& path, std::string message);
+
+    const studio::resources::resource_explorer& explorer;
+    studio::resources::task_pool& pool;
+    byte_budget budget;
+
+    std::function<void(const studio::resources::file_info&)> progress;
+    std::atomic_bool cancelled = false;
+
+    std::atomic_size_t files_written = 0;
+    std::atomic<std::uint64_t> bytes_written = 0;
+
+    std::mutex failure_mutex;
+    std::vector<failure> failures;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_BULK_EXTRACTOR_HPP
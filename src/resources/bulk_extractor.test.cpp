@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <string>
+#include "bulk_extractor.hpp"
+#include "three_space_volume.hpp"
+#include "zip_archive.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+TEST_CASE("Entries of several volumes are extracted to the same folders as single entries", "[resources]")
+{
+  const auto folder = make_test_folder("bulk-extract");
+
+  for (auto name : { "one.vol", "two.vol" })
+  {
+    write_file(folder / name, two_entry_volume);
+  }
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+
+  auto files = explorer.find_files({ ".txt" });
+  REQUIRE(files.size() == 4);
+
+  // Listing order is reversed to make sure entries are still read by offset,
+  // and the budget only allows a single entry to wait for its writer at a time.
+  std::reverse(files.begin(), files.end());
+
+  studio::resources::bulk_extractor extractor(explorer, 1);
+  const auto result = extractor.extract(files, folder / "extracted");
+
+  REQUIRE(result.files_written == 4);
+  REQUIRE(result.bytes_written == 10);
+
+  for (auto name : { "one", "two" })
+  {
+    REQUIRE(read_file(folder / "extracted" / name / "first.txt") == "ab");
+    REQUIRE(read_file(folder / "extracted" / name / "second.txt") == "cde");
+  }
+}
+
+TEST_CASE("A damaged entry is reported without stopping the rest of its volume", "[resources]")
+{
+  const auto folder = make_test_folder("bulk-extract-damaged");
+
+  // The deflated entry uses the reserved block type, and is listed before the entry after it.
+  write_file(folder / "damaged.zip", make_zip({
+    { "bad.txt", 8, to_bytes("\x07"), 5 },
+    { "good.txt", 0, to_bytes("good"), 4 },
+  }));
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".zip", std::make_unique<studio::resources::zip::zip_file_archive>());
+
+  // The budget only fits the damaged entry, so the entry after it is only read if its reservation was given back.
+  studio::resources::bulk_extractor extractor(explorer, 5);
+  const auto result = extractor.extract(explorer.find_files({ ".txt" }), folder / "extracted");
+
+  REQUIRE(result.files_written == 1);
+  REQUIRE(result.failures.size() == 1);
+  REQUIRE(result.failures[0].path == folder / "damaged.zip" / "bad.txt");
+  REQUIRE(read_file(folder / "extracted" / "damaged" / "good.txt") == "good");
+}
+
+TEST_CASE("Entries of RMF volumes are extracted from the volumes they are kept in", "[resources]")
+{
+  const auto folder = make_test_folder("bulk-extract-rmf");
+  write_rmf_volumes(folder);
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".rmf", std::make_unique<studio::resources::vol::three_space::rmf_file_archive>());
+
+  studio::resources::bulk_extractor extractor(explorer);
+  const auto result = extractor.extract(explorer.find_files({ ".txt" }), folder / "extracted");
+
+  REQUIRE(result.failures.empty());
+  REQUIRE(result.files_written == 3);
+  REQUIRE(result.bytes_written == 8);
+  REQUIRE(read_file(folder / "extracted" / "test" / "first" / "a.txt") == "abc");
+  REQUIRE(read_file(folder / "extracted" / "test" / "first" / "b.txt") == "de");
+  REQUIRE(read_file(folder / "extracted" / "test" / "second" / "c.txt") == "abc");
+}
@@ -0,0 +1,124 @@
+#ifndef DARKSTARDTSCONVERTER_CONCURRENT_CACHE_HPP
+#define DARKSTARDTSCONVERTER_CONCURRENT_CACHE_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <utility>
+#include <functional>
+
+namespace studio::resources
+{
+  // An insert-only cache which can be shared between threads.
+  // Entries are never removed while the cache is alive, so finding an existing entry only follows atomic pointers and takes no locks.
+  // Adding an entry locks a single shard, and the value is computed outside of the lock by the first thread to ask for it,
+  // while any other thread asking for the same key waits for that result instead of computing it again.
+  template<typename KeyType, typename ValueType, typename Hash = std::hash<KeyType>>
+  class concurrent_cache
+  {
+  public:
+    concurrent_cache() = default;
+    concurrent_cache(const concurrent_cache&) = delete;
+    concurrent_cache& operator=(const concurrent_cache&) = delete;
+
+    ~concurrent_cache()
+    {
+      for (auto& current_shard : shards)
+      {
+        for (auto& bucket : current_shard.buckets)
+        {
+          auto* current = bucket.load(std::memory_order_acquire);
+
+          while (current)
+          {
+            delete std::exchange(current, current->next);
+          }
+        }
+      }
+    }
+
+    template<typename Factory>
+    const ValueType& get_or_add(const KeyType& key, Factory&& create)
+    {
+      const auto hash = Hash{}(key);
+      auto& current_shard = shards[hash % shard_count];
+      auto& bucket = current_shard.buckets[(hash / shard_count) % bucket_count];
+
+      if (auto* existing = find(bucket, key); existing)
+      {
+        return existing->value.get();
+      }
+
+      entry* new_entry = nullptr;
+
+      {
+        std::lock_guard<std::mutex> lock(current_shard.mutex);
+
+        // Another thread may have added the key between the lookup and taking the lock.
+        if (auto* existing = find(bucket, key); existing)
+        {
+          return existing->value.get();
+        }
+
+        new_entry = new entry(key, bucket.load(std::memory_order_relaxed));
+        bucket.store(new_entry, std::memory_order_release);
+      }
+
+      try
+      {
+        new_entry->result.set_value(create());
+      }
+      catch (...)
+      {
+        // Failures are not kept, so that the next request for the key tries again.
+        new_entry->failed.store(true, std::memory_order_release);
+        new_entry->result.set_exception(std::current_exception());
+      }
+
+      return new_entry->value.get();
+    }
+
+  private:
+    constexpr static std::size_t shard_count = 16;
+    constexpr static std::size_t bucket_count = 64;
+
+    struct entry
+    {
+      entry(KeyType key, entry* next) : key(std::move(key)), next(next), value(result.get_future().share())
+      {
+      }
+
+      const KeyType key;
+      entry* const next;
+      std::promise<ValueType> result;
+      std::shared_future<ValueType> value;
+      std::atomic_bool failed = false;
+    };
+
+    struct shard
+    {
+      std::mutex mutex;
+      std::array<std::atomic<entry*>, bucket_count> buckets{};
+    };
+
+    static entry* find(const std::atomic<entry*>& bucket, const KeyType& key)
+    {
+      // Newer entries are added to the front, so a failed entry is always shadowed by any retry of it.
+      for (auto* current = bucket.load(std::memory_order_acquire); current; current = current->next)
+      {
+        if (current->key == key)
+        {
+          return current->failed.load(std::memory_order_acquire) ? nullptr : current;
+        }
+      }
+
+      return nullptr;
+    }
+
+    std::array<shard, shard_count> shards;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_CONCURRENT_CACHE_HPP
@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include "concurrent_cache.hpp"
+
+TEST_CASE("Concurrent requests for the same key compute the value once", "[resources]")
+{
+  studio::resources::concurrent_cache<std::string, std::vector<int>> cache;
+  std::atomic_int calls = 0;
+  std::atomic_int matches = 0;
+
+  std::vector<std::thread> threads;
+
+  for (auto i = 0; i < 8; ++i)
+  {
+    threads.emplace_back([&] {
+      const auto& result = cache.get_or_add("volume", [&] {
+        calls++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return std::vector<int>{ 1, 2, 3 };
+      });
+
+      if (result == std::vector<int>{ 1, 2, 3 })
+      {
+        matches++;
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  REQUIRE(calls == 1);
+  REQUIRE(matches == 8);
+}
+
+TEST_CASE("Failed values are computed again on the next request", "[resources]")
+{
+  studio::resources::concurrent_cache<std::string, int> cache;
+
+  REQUIRE_THROWS_AS(cache.get_or_add("volume", []() -> int { throw std::invalid_argument("bad volume"); }), std::invalid_argument);
+  REQUIRE(cache.get_or_add("volume", [] { return 42; }) == 42);
+  REQUIRE(cache.get_or_add("volume", [] { return 7; }) == 42);
+}
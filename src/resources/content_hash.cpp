@@ -0,0 +1,100 @@
+#include <cstring>
+#include "resources/content_hash.hpp"
+
+namespace studio::resources
+{
+  namespace
+  {
+    constexpr std::uint64_t prime1 = 11400714785074694791ull;
+    constexpr std::uint64_t prime2 = 14029467366897019727ull;
+    constexpr std::uint64_t prime3 = 1609587929392839161ull;
+    constexpr std::uint64_t prime4 = 9650029242287828579ull;
+    constexpr std::uint64_t prime5 = 2870177450012600261ull;
+
+    constexpr std::uint64_t rotate_left(std::uint64_t value, int count)
+    {
+      return (value << count) | (value >> (64 - count));
+    }
+
+    // Values are read as little endian, which is what every platform the studio runs on uses.
+    template<typename ValueType>
+    ValueType read(const std::byte* data)
+    {
+      ValueType result;
+      std::memcpy(&result, data, sizeof(result));
+      return result;
+    }
+
+    constexpr std::uint64_t round(std::uint64_t accumulator, std::uint64_t value)
+    {
+      return rotate_left(accumulator + value * prime2, 31) * prime1;
+    }
+
+    constexpr std::uint64_t merge_round(std::uint64_t hash, std::uint64_t lane)
+    {
+      return (hash ^ round(0, lane)) * prime1 + prime4;
+    }
+  }// namespace
+
+  std::uint64_t hash_content(nonstd::span<const std::byte> data, std::uint64_t seed)
+  {
+    const auto* current = data.data();
+    const auto* const end = current + data.size();
+    std::uint64_t hash;
+
+    if (data.size() >= 32)
+    {
+      std::uint64_t lane1 = seed + prime1 + prime2;
+      std::uint64_t lane2 = seed + prime2;
+      std::uint64_t lane3 = seed;
+      std::uint64_t lane4 = seed - prime1;
+
+      for (const auto* const last_stripe = end - 32; current <= last_stripe; current += 32)
+      {
+        lane1 = round(lane1, read<std::uint64_t>(current));
+        lane2 = round(lane2, read<std::uint64_t>(current + 8));
+        lane3 = round(lane3, read<std::uint64_t>(current + 16));
+        lane4 = round(lane4, read<std::uint64_t>(current + 24));
+      }
+
+      hash = rotate_left(lane1, 1) + rotate_left(lane2, 7) + rotate_left(lane3, 12) + rotate_left(lane4, 18);
+      hash = merge_round(hash, lane1);
+      hash = merge_round(hash, lane2);
+      hash = merge_round(hash, lane3);
+      hash = merge_round(hash, lane4);
+    }
+    else
+    {
+      hash = seed + prime5;
+    }
+
+    hash += std::uint64_t(data.size());
+
+    for (; current + 8 <= end; current += 8)
+    {
+      hash ^= round(0, read<std::uint64_t>(current));
+      hash = rotate_left(hash, 27) * prime1 + prime4;
+    }
+
+    if (current + 4 <= end)
+    {
+      hash ^= std::uint64_t(read<std::uint32_t>(current)) * prime1;
+      hash = rotate_left(hash, 23) * prime2 + prime3;
+      current += 4;
+    }
+
+    for (; current < end; ++current)
+    {
+      hash ^= std::to_integer<std::uint64_t>(*current) * prime5;
+      hash = rotate_left(hash, 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+
+    return hash;
+  }
+}// namespace studio::resources
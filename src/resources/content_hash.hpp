@@ -0,0 +1,15 @@
+#ifndef DARKSTARDTSCONVERTER_CONTENT_HASH_HPP
+#define DARKSTARDTSCONVERTER_CONTENT_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <nonstd/span.hpp>
+
+namespace studio::resources
+{
+  // XXH64, which gives the same results as the reference xxHash implementation.
+  // Input is consumed in 32 byte stripes by four independent lanes, which keeps several multiplies in flight at once.
+  std::uint64_t hash_content(nonstd::span<const std::byte> data, std::uint64_t seed = 0);
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_CONTENT_HASH_HPP
@@ -0,0 +1,73 @@
+#include <array>
+#include <cstring>
+#include "resources/crc32.hpp"
+
+namespace studio::resources
+{
+  namespace
+  {
+    using crc_tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+    // The first table is the usual byte-at-a-time table. Each of the others advances the one before it by another byte of zeroes.
+    constexpr crc_tables make_tables()
+    {
+      crc_tables tables{};
+
+      for (std::uint32_t i = 0; i < 256; ++i)
+      {
+        auto value = i;
+
+        for (auto bit = 0; bit < 8; ++bit)
+        {
+          value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+        }
+
+        tables[0][i] = value;
+      }
+
+      for (std::size_t i = 0; i < 256; ++i)
+      {
+        for (std::size_t slice = 1; slice < tables.size(); ++slice)
+        {
+          const auto previous = tables[slice - 1][i];
+          tables[slice][i] = (previous >> 8) ^ tables[0][previous & 0xff];
+        }
+      }
+
+      return tables;
+    }
+
+    constexpr auto tables = make_tables();
+
+    // Values are read as little endian, which is what every platform the studio runs on uses.
+    std::uint32_t read_uint32(const std::byte* data)
+    {
+      std::uint32_t result;
+      std::memcpy(&result, data, sizeof(result));
+      return result;
+    }
+  }// namespace
+
+  std::uint32_t crc32(nonstd::span<const std::byte> data, std::uint32_t previous)
+  {
+    auto crc = ~previous;
+    const auto* current = data.data();
+    auto remaining = data.size();
+
+    for (; remaining >= 8; remaining -= 8, current += 8)
+    {
+      const auto low = read_uint32(current) ^ crc;
+      const auto high = read_uint32(current + 4);
+
+      crc = tables[7][low & 0xff] ^ tables[6][(low >> 8) & 0xff] ^ tables[5][(low >> 16) & 0xff] ^ tables[4][low >> 24]
+            ^ tables[3][high & 0xff] ^ tables[2][(high >> 8) & 0xff] ^ tables[1][(high >> 16) & 0xff] ^ tables[0][high >> 24];
+    }
+
+    for (; remaining > 0; --remaining, ++current)
+    {
+      crc = (crc >> 8) ^ tables[0][(crc ^ std::to_integer<std::uint32_t>(*current)) & 0xff];
+    }
+
+    return ~crc;
+  }
+}// namespace studio::resources
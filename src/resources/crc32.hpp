@@ -0,0 +1,15 @@
+#ifndef DARKSTARDTSCONVERTER_CRC32_HPP
+#define DARKSTARDTSCONVERTER_CRC32_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <nonstd/span.hpp>
+
+namespace studio::resources
+{
+  // The CRC32 used by zip and PNG, calculated with slice-by-8 tables so that each step consumes eight bytes.
+  // Passing the result of an earlier call as "previous" continues it, as if both inputs had been passed at once.
+  std::uint32_t crc32(nonstd::span<const std::byte> data, std::uint32_t previous = 0);
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_CRC32_HPP
@@ -0,0 +1,894 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include "resources/darkstar_compression.hpp"
+
+namespace studio::resources::vol::darkstar
+{
+  constexpr auto window_mask = window_size - 1;
+
+  static_assert((window_size & window_mask) == 0, "The window size must be a power of two.");
+
+  // LZH stores the upper 6 bits of a match position with a fixed prefix code.
+  // These are the code lengths for each of the 64 values, from which the canonical codes are derived.
+  constexpr std::array<std::uint8_t, 64> position_code_lengths = {
+    3, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8
+  };
+
+  struct position_decode_table
+  {
+    std::array<std::uint8_t, 256> upper_bits;
+    std::array<std::uint8_t, 256> code_lengths;
+  };
+
+  constexpr position_decode_table make_position_decode_table()
+  {
+    position_decode_table table{};
+    std::size_t code = 0;
+
+    for (auto i = 0u; i < position_code_lengths.size(); ++i)
+    {
+      const auto span = std::size_t(256) >> position_code_lengths[i];
+
+      for (auto j = 0u; j < span; ++j)
+      {
+        table.upper_bits[code + j] = std::uint8_t(i);
+        table.code_lengths[code + j] = position_code_lengths[i];
+      }
+
+      code += span;
+    }
+
+    return table;
+  }
+
+  constexpr auto position_table = make_position_decode_table();
+
+  // The codes themselves, left aligned in a byte, for the encoder.
+  constexpr std::array<std::uint8_t, 64> make_position_codes()
+  {
+    std::array<std::uint8_t, 64> codes{};
+    std::size_t code = 0;
+
+    for (auto i = 0u; i < position_code_lengths.size(); ++i)
+    {
+      codes[i] = std::uint8_t(code);
+      code += std::size_t(256) >> position_code_lengths[i];
+    }
+
+    return codes;
+  }
+
+  constexpr auto position_codes = make_position_codes();
+
+  template<typename Decoder>
+  inline void put_literal(Decoder& state, std::byte value, std::byte* output)
+  {
+    *output = value;
+    state.window[state.window_position] = value;
+    state.window_position = (state.window_position + 1) & window_mask;
+  }
+
+  // Copies as much of a pending match as will fit into the output, while also appending it to the window.
+  // When neither range wraps around the window and they don't overlap, the copy is done in bulk.
+  template<typename Decoder>
+  std::size_t copy_match(Decoder& state, std::byte* output, std::size_t output_size)
+  {
+    const auto count = std::min(state.match_remaining, output_size);
+    const auto source = state.match_position;
+    const auto destination = state.window_position;
+
+    if (source + count <= window_size && destination + count <= window_size
+        && (source + count <= destination || destination + count <= source))
+    {
+      std::memcpy(output, state.window.data() + source, count);
+      std::memcpy(state.window.data() + destination, output, count);
+    }
+    else
+    {
+      for (auto i = 0u; i < count; ++i)
+      {
+        const auto value = state.window[(source + i) & window_mask];
+        output[i] = value;
+        state.window[(destination + i) & window_mask] = value;
+      }
+    }
+
+    state.match_position = (source + count) & window_mask;
+    state.window_position = (destination + count) & window_mask;
+    state.match_remaining -= count;
+
+    return count;
+  }
+
+  std::size_t rle_decoder::decode(bounded_reader& input, std::byte* output, std::size_t output_size)
+  {
+    std::size_t written = 0;
+
+    while (written < output_size)
+    {
+      if (run_remaining > 0)
+      {
+        const auto count = std::min(run_remaining, output_size - written);
+        std::fill_n(output + written, count, run_value);
+        written += count;
+        run_remaining -= count;
+        continue;
+      }
+
+      if (literal_remaining > 0)
+      {
+        const auto value = input.get();
+
+        if (value < 0)
+        {
+          break;
+        }
+
+        output[written++] = std::byte(value);
+        literal_remaining--;
+        continue;
+      }
+
+      // The high bit of the control byte marks a run of a single value,
+      // otherwise the control byte is the number of literal bytes which follow it.
+      const auto control = input.get();
+
+      if (control < 0)
+      {
+        break;
+      }
+
+      if (control & 0x80)
+      {
+        const auto value = input.get();
+
+        if (value < 0)
+        {
+          break;
+        }
+
+        run_value = std::byte(value);
+        run_remaining = std::size_t(control & 0x7f);
+      }
+      else
+      {
+        literal_remaining = std::size_t(control);
+      }
+    }
+
+    return written;
+  }
+
+  lz_decoder::lz_decoder()
+  {
+    window.fill(std::byte{ ' ' });
+  }
+
+  std::size_t lz_decoder::decode(bounded_reader& input, std::byte* output, std::size_t output_size)
+  {
+    std::size_t written = 0;
+
+    while (written < output_size)
+    {
+      if (match_remaining > 0)
+      {
+        written += copy_match(*this, output + written, output_size - written);
+        continue;
+      }
+
+      // Each flag byte describes the next 8 items, with the low bit first.
+      // The upper byte is used to know when all 8 flags have been consumed.
+      flags >>= 1;
+
+      if ((flags & 0x100) == 0)
+      {
+        const auto value = input.get();
+
+        if (value < 0)
+        {
+          break;
+        }
+
+        flags = std::uint32_t(value) | 0xff00;
+      }
+
+      if (flags & 1)
+      {
+        const auto value = input.get();
+
+        if (value < 0)
+        {
+          break;
+        }
+
+        put_literal(*this, std::byte(value), output + written++);
+      }
+      else
+      {
+        const auto low = input.get();
+        const auto high = input.get();
+
+        if (low < 0 || high < 0)
+        {
+          break;
+        }
+
+        match_position = std::size_t(low) | (std::size_t(high & 0xf0) << 4);
+        match_remaining = std::size_t(high & 0x0f) + threshold + 1;
+      }
+    }
+
+    return written;
+  }
+
+  lzh_decoder::lzh_decoder()
+  {
+    window.fill(std::byte{ ' ' });
+
+    for (auto i = 0u; i < char_count; ++i)
+    {
+      frequencies[i] = 1;
+      children[i] = std::uint16_t(i + table_size);
+      parents[i + table_size] = std::uint16_t(i);
+    }
+
+    for (auto i = 0u, j = std::uint32_t(char_count); j <= root; i += 2, ++j)
+    {
+      frequencies[j] = std::uint16_t(frequencies[i] + frequencies[i + 1]);
+      children[j] = std::uint16_t(i);
+      parents[i] = parents[i + 1] = std::uint16_t(j);
+    }
+
+    frequencies[table_size] = 0xffff;
+    parents[root] = 0;
+  }
+
+  void lzh_decoder::rebuild_tree()
+  {
+    // Collect the leaves and halve their frequencies.
+    auto j = 0u;
+    for (auto i = 0u; i < table_size; ++i)
+    {
+      if (children[i] >= table_size)
+      {
+        frequencies[j] = std::uint16_t((frequencies[i] + 1) / 2);
+        children[j] = children[i];
+        j++;
+      }
+    }
+
+    // Then rebuild the tree, keeping the nodes sorted by frequency.
+    for (auto i = 0u, node = std::uint32_t(char_count); node < table_size; i += 2, ++node)
+    {
+      const auto frequency = std::uint16_t(frequencies[i] + frequencies[i + 1]);
+      frequencies[node] = frequency;
+
+      auto insert_at = node - 1;
+      while (frequency < frequencies[insert_at])
+      {
+        insert_at--;
+      }
+      insert_at++;
+
+      std::copy_backward(frequencies.begin() + insert_at, frequencies.begin() + node, frequencies.begin() + node + 1);
+      frequencies[insert_at] = frequency;
+
+      std::copy_backward(children.begin() + insert_at, children.begin() + node, children.begin() + node + 1);
+      children[insert_at] = std::uint16_t(i);
+    }
+
+    for (auto i = 0u; i < table_size; ++i)
+    {
+      const auto child = children[i];
+      parents[child] = std::uint16_t(i);
+
+      if (child < table_size)
+      {
+        parents[child + 1] = std::uint16_t(i);
+      }
+    }
+  }
+
+  void lzh_decoder::update(std::size_t symbol)
+  {
+    if (frequencies[root] == max_frequency)
+    {
+      rebuild_tree();
+    }
+
+    auto node = std::size_t(parents[symbol + table_size]);
+
+    do
+    {
+      const auto frequency = std::uint32_t(++frequencies[node]);
+
+      // Swap the node with the last node of a lower frequency, to keep the list sorted.
+      if (auto other = node + 1; frequency > frequencies[other])
+      {
+        while (frequency > frequencies[++other])
+        {
+        }
+        other--;
+
+        frequencies[node] = frequencies[other];
+        frequencies[other] = std::uint16_t(frequency);
+
+        const auto child = children[node];
+        parents[child] = std::uint16_t(other);
+        if (child < table_size)
+        {
+          parents[child + 1] = std::uint16_t(other);
+        }
+
+        const auto other_child = children[other];
+        children[other] = child;
+
+        parents[other_child] = std::uint16_t(node);
+        if (other_child < table_size)
+        {
+          parents[other_child + 1] = std::uint16_t(node);
+        }
+        children[node] = other_child;
+
+        node = other;
+      }
+
+      node = parents[node];
+    } while (node != 0);
+  }
+
+  int lzh_decoder::get_bit(bounded_reader& input)
+  {
+    if (bit_count == 0)
+    {
+      auto value = input.get();
+
+      if (value < 0)
+      {
+        exhausted = true;
+        value = 0;
+      }
+
+      bit_buffer = std::uint32_t(value);
+      bit_count = 8;
+    }
+
+    bit_count--;
+    return int((bit_buffer >> bit_count) & 1);
+  }
+
+  int lzh_decoder::get_byte(bounded_reader& input)
+  {
+    auto value = input.get();
+
+    if (value < 0)
+    {
+      exhausted = true;
+      value = 0;
+    }
+
+    if (bit_count == 0)
+    {
+      return value;
+    }
+
+    // The unread low bits of the previous byte come first, followed by the top of the new one.
+    const auto result = ((bit_buffer << 8) | std::uint32_t(value)) >> bit_count;
+    bit_buffer = std::uint32_t(value);
+
+    return int(result & 0xff);
+  }
+
+  std::size_t lzh_decoder::decode_symbol(bounded_reader& input)
+  {
+    auto node = std::size_t(children[root]);
+
+    while (node < table_size)
+    {
+      node += std::size_t(get_bit(input));
+      node = children[node];
+    }
+
+    node -= table_size;
+    update(node);
+
+    return node;
+  }
+
+  std::size_t lzh_decoder::decode_position(bounded_reader& input)
+  {
+    auto value = std::size_t(get_byte(input));
+    const auto upper = std::size_t(position_table.upper_bits[value]) << 6;
+    auto remaining_bits = position_table.code_lengths[value] - 2;
+
+    while (remaining_bits-- > 0)
+    {
+      value = (value << 1) | std::size_t(get_bit(input));
+    }
+
+    return upper | (value & 0x3f);
+  }
+
+  std::size_t lzh_decoder::decode(bounded_reader& input, std::byte* output, std::size_t output_size)
+  {
+    std::size_t written = 0;
+
+    while (written < output_size && !exhausted)
+    {
+      if (match_remaining > 0)
+      {
+        written += copy_match(*this, output + written, output_size - written);
+        continue;
+      }
+
+      const auto symbol = decode_symbol(input);
+
+      if (symbol < 256)
+      {
+        if (exhausted)
+        {
+          break;
+        }
+
+        put_literal(*this, std::byte(symbol), output + written++);
+      }
+      else
+      {
+        const auto distance = decode_position(input);
+
+        if (exhausted)
+        {
+          break;
+        }
+
+        match_position = (window_position - distance - 1) & window_mask;
+        match_remaining = symbol - 255 + threshold;
+      }
+    }
+
+    return written;
+  }
+
+  decoder make_decoder(studio::resources::compression_type type)
+  {
+    switch (type)
+    {
+    case studio::resources::compression_type::rle:
+      return rle_decoder{};
+    case studio::resources::compression_type::lz:
+      return lz_decoder{};
+    case studio::resources::compression_type::lzh:
+      return lzh_decoder{};
+    default:
+      throw std::invalid_argument("There is no decoder for uncompressed data.");
+    }
+  }
+
+  std::size_t decode(decoder& state, bounded_reader& input, std::byte* output, std::size_t output_size)
+  {
+    return std::visit([&](auto& real_state) { return real_state.decode(input, output, output_size); }, state);
+  }
+
+  void decompress(std::basic_istream<std::byte>& input,
+    std::size_t compressed_size,
+    std::size_t uncompressed_size,
+    studio::resources::compression_type type,
+    std::basic_ostream<std::byte>& output)
+  {
+    bounded_reader reader(input, compressed_size);
+    auto state = make_decoder(type);
+
+    std::vector<std::byte> buffer(std::min(uncompressed_size, std::size_t(65536)));
+
+    auto remaining = uncompressed_size;
+
+    while (remaining > 0)
+    {
+      const auto count = decode(state, reader, buffer.data(), std::min(remaining, buffer.size()));
+
+      if (count == 0)
+      {
+        break;
+      }
+
+      output.write(buffer.data(), std::streamsize(count));
+      remaining -= count;
+    }
+
+    if (remaining > 0)
+    {
+      throw std::invalid_argument("The compressed data ends before the expected size.");
+    }
+  }
+
+  seekable_decoder::seekable_decoder(studio::resources::compression_type type,
+    std::size_t compressed_size,
+    std::size_t uncompressed_size,
+    std::size_t checkpoint_interval)
+    : type(type),
+      compressed_size(compressed_size),
+      uncompressed_size(uncompressed_size),
+      checkpoint_interval(std::max<std::size_t>(checkpoint_interval, 1))
+  {
+    if (type != studio::resources::compression_type::none)
+    {
+      checkpoints.push_back({ 0, 0, make_decoder(type) });
+    }
+  }
+
+  std::size_t seekable_decoder::read(std::basic_istream<std::byte>& input, std::streamoff data_offset, std::size_t position, std::byte* output, std::size_t size)
+  {
+    if (position >= uncompressed_size)
+    {
+      return 0;
+    }
+
+    size = std::min(size, uncompressed_size - position);
+
+    if (type == studio::resources::compression_type::none)
+    {
+      input.clear();
+      input.seekg(data_offset + std::streamoff(position), std::ios::beg);
+      input.read(output, std::streamsize(size));
+      return std::size_t(input.gcount());
+    }
+
+    // The first checkpoint is always at the start, so there is always one at or before the position.
+    const auto nearest = std::prev(std::upper_bound(checkpoints.begin(), checkpoints.end(), position, [](auto value, const auto& checkpoint) {
+      return value < checkpoint.output_offset;
+    }));
+
+    auto state = nearest->state;
+    auto current = nearest->output_offset;
+    const auto input_offset = nearest->input_offset;
+
+    input.clear();
+    input.seekg(data_offset + std::streamoff(input_offset), std::ios::beg);
+    bounded_reader reader(input, compressed_size - input_offset);
+
+    const auto end = position + size;
+
+    while (current < end)
+    {
+      std::byte* target = output + (current - position);
+      auto limit = end - current;
+
+      // Anything before the position still has to be decoded, but goes nowhere.
+      if (current < position)
+      {
+        skipped.resize(std::min(position - current, std::size_t(65536)));
+        target = skipped.data();
+        limit = skipped.size();
+      }
+
+      // Checkpoints sit at multiples of the interval, and decoding stops at each of them in case it hasn't been recorded yet.
+      limit = std::min(limit, (current / checkpoint_interval + 1) * checkpoint_interval - current);
+
+      const auto count = decode(state, reader, target, limit);
+
+      if (count == 0)
+      {
+        break;
+      }
+
+      current += count;
+
+      if (current == checkpoints.back().output_offset + checkpoint_interval && current < uncompressed_size)
+      {
+        checkpoints.push_back({ current, input_offset + reader.consumed(), state });
+      }
+    }
+
+    return current > position ? current - position : 0;
+  }
+
+  std::size_t seekable_decoder::size() const
+  {
+    return uncompressed_size;
+  }
+
+  std::size_t seekable_decoder::checkpoint_count() const
+  {
+    return checkpoints.size();
+  }
+
+  namespace
+  {
+    // Finds earlier occurrences of the bytes at a position, by following a chain of the positions which share the same 3 byte hash.
+    // Chains are cut short after a fixed number of steps, which trades a little bit of compression for a predictable speed.
+    class match_finder
+    {
+    public:
+      constexpr static std::size_t min_match_size = 3;
+
+      explicit match_finder(nonstd::span<const std::byte> input)
+        : input(input), heads(hash_size, no_position), previous(input.size(), no_position)
+      {
+      }
+
+      // Returns the size and the start of the longest match which is at most max_distance bytes back.
+      std::pair<std::size_t, std::size_t> find(std::size_t position, std::size_t max_size, std::size_t max_distance) const
+      {
+        if (position + min_match_size > input.size())
+        {
+          return std::make_pair(0, 0);
+        }
+
+        max_size = std::min(max_size, input.size() - position);
+
+        std::size_t best_size = 0;
+        std::size_t best_start = 0;
+
+        auto candidate = heads[hash(position)];
+
+        for (auto steps = 0u; candidate != no_position && steps < max_chain_steps && position - candidate <= max_distance; ++steps)
+        {
+          std::size_t size = 0;
+
+          while (size < max_size && input[candidate + size] == input[position + size])
+          {
+            size++;
+          }
+
+          if (size > best_size)
+          {
+            best_size = size;
+            best_start = candidate;
+
+            if (size == max_size)
+            {
+              break;
+            }
+          }
+
+          candidate = previous[candidate];
+        }
+
+        return std::make_pair(best_size, best_start);
+      }
+
+      void insert(std::size_t position)
+      {
+        if (position + min_match_size > input.size())
+        {
+          return;
+        }
+
+        auto& head = heads[hash(position)];
+        previous[position] = head;
+        head = position;
+      }
+
+    private:
+      constexpr static std::size_t hash_size = 1 << 15;
+      constexpr static std::size_t max_chain_steps = 64;
+      constexpr static std::size_t no_position = std::numeric_limits<std::size_t>::max();
+
+      std::size_t hash(std::size_t position) const
+      {
+        const auto value = std::to_integer<std::size_t>(input[position]) << 16
+                           | std::to_integer<std::size_t>(input[position + 1]) << 8
+                           | std::to_integer<std::size_t>(input[position + 2]);
+
+        return (value * 2654435761u >> 12) & (hash_size - 1);
+      }
+
+      nonstd::span<const std::byte> input;
+      std::vector<std::size_t> heads;
+      std::vector<std::size_t> previous;
+    };
+
+    // Writes values with their most significant bit first, which is the order lzh_decoder reads them in.
+    struct bit_writer
+    {
+      std::vector<std::byte>& output;
+      std::uint32_t buffer = 0;
+      std::uint32_t count = 0;
+
+      void put(std::uint32_t value, std::uint32_t bits)
+      {
+        while (bits-- > 0)
+        {
+          buffer = (buffer << 1) | ((value >> bits) & 1);
+
+          if (++count == 8)
+          {
+            output.push_back(std::byte(buffer));
+            buffer = 0;
+            count = 0;
+          }
+        }
+      }
+
+      void flush()
+      {
+        if (count > 0)
+        {
+          output.push_back(std::byte(buffer << (8 - count)));
+          buffer = 0;
+          count = 0;
+        }
+      }
+    };
+
+    std::vector<std::byte> compress_rle(nonstd::span<const std::byte> input)
+    {
+      constexpr std::size_t max_count = 0x7f;
+      constexpr std::size_t min_run = 3;
+
+      std::vector<std::byte> output;
+      output.reserve(input.size() + input.size() / max_count + 1);
+
+      auto run_size = [&](std::size_t position) {
+        std::size_t size = 1;
+
+        while (size < max_count && position + size < input.size() && input[position + size] == input[position])
+        {
+          size++;
+        }
+
+        return size;
+      };
+
+      std::size_t position = 0;
+
+      while (position < input.size())
+      {
+        if (const auto size = run_size(position); size >= min_run)
+        {
+          output.push_back(std::byte(0x80 | size));
+          output.push_back(input[position]);
+          position += size;
+          continue;
+        }
+
+        const auto start = position;
+
+        while (position < input.size() && position - start < max_count && run_size(position) < min_run)
+        {
+          position++;
+        }
+
+        output.push_back(std::byte(position - start));
+        output.insert(output.end(), input.begin() + start, input.begin() + position);
+      }
+
+      return output;
+    }
+
+    std::vector<std::byte> compress_lz(nonstd::span<const std::byte> input)
+    {
+      constexpr auto min_match_size = lz_decoder::threshold + 1;
+      constexpr auto max_match_size = lz_decoder::max_match_size;
+      constexpr auto first_position = window_size - max_match_size;
+
+      std::vector<std::byte> output;
+      output.reserve(input.size() + input.size() / 8 + 1);
+
+      match_finder finder(input);
+
+      std::size_t flag_index = 0;
+      auto item = 8u;
+      std::size_t position = 0;
+
+      while (position < input.size())
+      {
+        if (item == 8)
+        {
+          flag_index = output.size();
+          output.emplace_back();
+          item = 0;
+        }
+
+        // Matches are kept close enough that their source is never overwritten while the match is being copied.
+        const auto [size, start] = finder.find(position, max_match_size, window_size - max_match_size);
+
+        if (size >= min_match_size)
+        {
+          const auto window_start = (first_position + start) & window_mask;
+
+          output.push_back(std::byte(window_start & 0xff));
+          output.push_back(std::byte(((window_start >> 4) & 0xf0) | (size - min_match_size)));
+
+          for (auto i = 0u; i < size; ++i)
+          {
+            finder.insert(position++);
+          }
+        }
+        else
+        {
+          output[flag_index] |= std::byte(1 << item);
+          output.push_back(input[position]);
+          finder.insert(position++);
+        }
+
+        item++;
+      }
+
+      return output;
+    }
+
+    std::vector<std::byte> compress_lzh(nonstd::span<const std::byte> input)
+    {
+      constexpr auto min_match_size = lzh_decoder::threshold + 1;
+      constexpr auto max_match_size = lzh_decoder::max_match_size;
+
+      std::vector<std::byte> output;
+      output.reserve(input.size());
+
+      bit_writer writer{ output };
+      match_finder finder(input);
+      lzh_decoder model;
+
+      // Symbols are written as the path from the root of the tree to their leaf.
+      auto put_symbol = [&](std::size_t symbol) {
+        std::array<std::uint8_t, lzh_decoder::table_size> path{};
+        std::size_t depth = 0;
+
+        for (auto node = std::size_t(model.parents[symbol + lzh_decoder::table_size]); node != lzh_decoder::root; node = model.parents[node])
+        {
+          path[depth++] = std::uint8_t(node & 1);
+        }
+
+        while (depth > 0)
+        {
+          writer.put(path[--depth], 1);
+        }
+
+        model.update(symbol);
+      };
+
+      std::size_t position = 0;
+
+      while (position < input.size())
+      {
+        const auto [size, start] = finder.find(position, max_match_size, window_size - max_match_size);
+
+        if (size >= min_match_size)
+        {
+          put_symbol(size + 255 - lzh_decoder::threshold);
+
+          const auto distance = position - start - 1;
+          const auto upper = distance >> 6;
+          writer.put(position_codes[upper] >> (8 - position_code_lengths[upper]), position_code_lengths[upper]);
+          writer.put(std::uint32_t(distance & 0x3f), 6);
+
+          for (auto i = 0u; i < size; ++i)
+          {
+            finder.insert(position++);
+          }
+        }
+        else
+        {
+          put_symbol(std::to_integer<std::size_t>(input[position]));
+          finder.insert(position++);
+        }
+      }
+
+      writer.flush();
+
+      return output;
+    }
+  }// namespace
+
+  std::vector<std::byte> compress(nonstd::span<const std::byte> input, studio::resources::compression_type type)
+  {
+    switch (type)
+    {
+    case studio::resources::compression_type::rle:
+      return compress_rle(input);
+    case studio::resources::compression_type::lz:
+      return compress_lz(input);
+    case studio::resources::compression_type::lzh:
+      return compress_lzh(input);
+    default:
+      return std::vector<std::byte>(input.begin(), input.end());
+    }
+  }
+}// namespace studio::resources::vol::darkstar
@@ -0,0 +1,139 @@
+#ifndef DARKSTARDTSCONVERTER_DARKSTAR_COMPRESSION_HPP
+#define DARKSTARDTSCONVERTER_DARKSTAR_COMPRESSION_HPP
+
+#include <array>
+#include <vector>
+#include <variant>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <nonstd/span.hpp>
+#include "archive_plugin.hpp"
+#include "bounded_reader.hpp"
+
+namespace studio::resources::vol::darkstar
+{
+  // Both LZ variants use a 4k sliding window which starts off filled with spaces.
+  constexpr std::size_t window_size = 4096;
+
+  // Each decoder produces its output incrementally. A call to decode fills as much
+  // of the output buffer as it can and keeps any unfinished run or match for the next call,
+  // which means the entire state of a decoder can be copied and resumed later on.
+  struct rle_decoder
+  {
+    std::size_t decode(bounded_reader& input, std::byte* output, std::size_t output_size);
+
+    std::size_t run_remaining = 0;
+    std::size_t literal_remaining = 0;
+    std::byte run_value{};
+  };
+
+  struct lz_decoder
+  {
+    constexpr static std::size_t max_match_size = 18;
+    constexpr static std::size_t threshold = 2;
+
+    lz_decoder();
+
+    std::size_t decode(bounded_reader& input, std::byte* output, std::size_t output_size);
+
+    std::array<std::byte, window_size> window;
+    std::size_t window_position = window_size - max_match_size;
+    std::uint32_t flags = 0;
+    std::size_t match_position = 0;
+    std::size_t match_remaining = 0;
+  };
+
+  struct lzh_decoder
+  {
+    constexpr static std::size_t max_match_size = 60;
+    constexpr static std::size_t threshold = 2;
+    constexpr static std::size_t char_count = 256 - threshold + max_match_size;
+    constexpr static std::size_t table_size = char_count * 2 - 1;
+    constexpr static std::size_t root = table_size - 1;
+    constexpr static std::uint16_t max_frequency = 0x8000;
+
+    lzh_decoder();
+
+    std::size_t decode(bounded_reader& input, std::byte* output, std::size_t output_size);
+
+    void update(std::size_t symbol);
+
+    std::array<std::byte, window_size> window;
+    std::size_t window_position = window_size - max_match_size;
+    std::size_t match_position = 0;
+    std::size_t match_remaining = 0;
+
+    std::array<std::uint16_t, table_size + 1> frequencies;
+    std::array<std::uint16_t, table_size + char_count> parents;
+    std::array<std::uint16_t, table_size> children;
+
+    std::uint32_t bit_buffer = 0;
+    std::uint32_t bit_count = 0;
+    bool exhausted = false;
+
+  private:
+    void rebuild_tree();
+    int get_bit(bounded_reader& input);
+    int get_byte(bounded_reader& input);
+    std::size_t decode_symbol(bounded_reader& input);
+    std::size_t decode_position(bounded_reader& input);
+  };
+
+  using decoder = std::variant<rle_decoder, lz_decoder, lzh_decoder>;
+
+  decoder make_decoder(studio::resources::compression_type type);
+
+  std::size_t decode(decoder& state, bounded_reader& input, std::byte* output, std::size_t output_size);
+
+  // The output offset, input offset and decoder state at some point of an entry, from which decoding can resume.
+  struct decode_checkpoint
+  {
+    std::size_t output_offset;
+    std::size_t input_offset;
+    decoder state;
+  };
+
+  // Reads arbitrary ranges of a compressed entry. Checkpoints are recorded every "checkpoint_interval" bytes of output
+  // the first time decoding gets that far, so that later reads only have to decode from the nearest one.
+  // Uncompressed entries are read from the stream directly.
+  class seekable_decoder
+  {
+  public:
+    constexpr static std::size_t default_checkpoint_interval = 64 * 1024;
+
+    seekable_decoder(studio::resources::compression_type type,
+      std::size_t compressed_size,
+      std::size_t uncompressed_size,
+      std::size_t checkpoint_interval = default_checkpoint_interval);
+
+    // The compressed data starts at "data_offset" in the input. Returns the number of bytes read,
+    // which is only less than "size" at the end of the entry, or when the data is truncated.
+    std::size_t read(std::basic_istream<std::byte>& input, std::streamoff data_offset, std::size_t position, std::byte* output, std::size_t size);
+
+    std::size_t size() const;
+
+    std::size_t checkpoint_count() const;
+
+  private:
+    studio::resources::compression_type type;
+    std::size_t compressed_size;
+    std::size_t uncompressed_size;
+    std::size_t checkpoint_interval;
+    std::vector<decode_checkpoint> checkpoints;
+    std::vector<std::byte> skipped;
+  };
+
+  // Data which ends before "uncompressed_size" bytes have been decoded is rejected with std::invalid_argument.
+  void decompress(std::basic_istream<std::byte>& input,
+    std::size_t compressed_size,
+    std::size_t uncompressed_size,
+    studio::resources::compression_type type,
+    std::basic_ostream<std::byte>& output);
+
+  // Produces data which decompress turns back into the input, for the same type of compression.
+  // LZH shares its adaptive tree with the decoder, so that both sides update it in exactly the same way.
+  std::vector<std::byte> compress(nonstd::span<const std::byte> input, studio::resources::compression_type type);
+}// namespace studio::resources::vol::darkstar
+
+#endif//DARKSTARDTSCONVERTER_DARKSTAR_COMPRESSION_HPP
@@ -0,0 +1,145 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <algorithm>
+#include <string>
+#include "darkstar_compression.hpp"
+#include "darkstar_entry_stream.hpp"
+
+namespace
+{
+  std::basic_string<std::byte> to_bytes(const std::vector<std::uint8_t>& values)
+  {
+    std::basic_string<std::byte> result;
+
+    for (auto value : values)
+    {
+      result.push_back(std::byte(value));
+    }
+
+    return result;
+  }
+
+  std::string decompress(const std::vector<std::uint8_t>& values, std::size_t size, studio::resources::compression_type type)
+  {
+    std::basic_stringstream<std::byte> input(to_bytes(values));
+    std::basic_stringstream<std::byte> output;
+
+    studio::resources::vol::darkstar::decompress(input, values.size(), size, type, output);
+
+    const auto raw = output.str();
+    return std::string(reinterpret_cast<const char*>(raw.data()), raw.size());
+  }
+
+  // Text, long runs and noise, with enough symbols to make LZH rebuild its tree and LZ wrap around its window.
+  std::vector<std::uint8_t> make_sample()
+  {
+    std::vector<std::uint8_t> values;
+    std::uint32_t seed = 12345;
+
+    for (auto i = 0u; values.size() < 100000; ++i)
+    {
+      for (auto c : std::string_view("The quick brown fox jumps over the lazy dog. "))
+      {
+        values.push_back(std::uint8_t(c));
+      }
+
+      values.insert(values.end(), i % 200, std::uint8_t(i));
+
+      for (auto j = 0u; j < 32; ++j)
+      {
+        seed = seed * 1103515245u + 12345u;
+        values.push_back(std::uint8_t(seed >> 16));
+      }
+    }
+
+    return values;
+  }
+}// namespace
+
+TEST_CASE("RLE data is decoded correctly", "[vol.darkstar]")
+{
+  REQUIRE(decompress({ 0x83, 'a', 0x02, 'b', 'c', 0x81, 'd' }, 6, studio::resources::compression_type::rle) == "aaabcd");
+}
+
+TEST_CASE("LZ literals and matches are decoded correctly", "[vol.darkstar]")
+{
+  // Three literals, followed by a six byte match starting at the first literal (window position 4078).
+  REQUIRE(decompress({ 0x07, 'a', 'b', 'c', 0xee, 0xf3 }, 9, studio::resources::compression_type::lz) == "abcabcabc");
+}
+
+TEST_CASE("LZ matches can refer to the initial window", "[vol.darkstar]")
+{
+  REQUIRE(decompress({ 0x01, 'x', 0x00, 0x00 }, 4, studio::resources::compression_type::lz) == "x   ");
+}
+
+TEST_CASE("LZ output stops at the expected size", "[vol.darkstar]")
+{
+  REQUIRE(decompress({ 0x07, 'a', 'b', 'c', 0xee, 0xf3 }, 5, studio::resources::compression_type::lz) == "abcab");
+}
+
+TEST_CASE("Compressed data which ends early is rejected", "[vol.darkstar]")
+{
+  REQUIRE_THROWS_AS(decompress({ 0x07, 'a', 'b', 'c', 0xee, 0xf3 }, 12, studio::resources::compression_type::lz), std::invalid_argument);
+  REQUIRE_THROWS_AS(decompress({ 0x83, 'a' }, 4, studio::resources::compression_type::rle), std::invalid_argument);
+}
+
+// Produced by the encoders of Okumura's LZSS.C and LZHUF.C, which volumes are compressed with.
+// LZHUF.C writes the decoded size in front of the data, which volumes keep in the entry header instead.
+TEST_CASE("Data from the reference encoders is decoded correctly", "[vol.darkstar]")
+{
+  constexpr auto text = "abcabcabcabc hello hello hello world";
+
+  REQUIRE(decompress({ 0xf7, 0x61, 0x62, 0x63, 0xee, 0xf6, 0x20, 0x68, 0x65, 0x6c, 0xfb, 0x6c, 0x6f, 0xfa, 0xfa, 0x77, 0x6f, 0x72, 0x6c, 0x64 },
+            36, studio::resources::compression_type::lz)
+          == text);
+
+  REQUIRE(decompress({ 0xf6, 0xfb, 0xbd, 0xf2, 0x40, 0x2d, 0x67, 0xd3, 0xe3, 0xf8, 0xbe, 0xfd, 0xcb, 0x01, 0x40, 0xef, 0x7f, 0xd7, 0x3e, 0x00 },
+            36, studio::resources::compression_type::lzh)
+          == text);
+}
+
+TEST_CASE("Compressed data decodes back to the original", "[vol.darkstar]")
+{
+  const auto values = make_sample();
+  const auto input = to_bytes(values);
+  const auto expected = std::string(reinterpret_cast<const char*>(input.data()), input.size());
+
+  for (auto type : { studio::resources::compression_type::rle, studio::resources::compression_type::lz, studio::resources::compression_type::lzh })
+  {
+    const auto compressed = studio::resources::vol::darkstar::compress(nonstd::span<const std::byte>(input.data(), input.size()), type);
+
+    std::vector<std::uint8_t> raw(compressed.size());
+    std::transform(compressed.begin(), compressed.end(), raw.begin(), [](auto value) { return std::to_integer<std::uint8_t>(value); });
+
+    REQUIRE(compressed.size() < input.size());
+    REQUIRE(decompress(raw, input.size(), type) == expected);
+  }
+}
+
+TEST_CASE("Compressed data is read from the nearest checkpoint", "[vol.darkstar]")
+{
+  const auto input = to_bytes(make_sample());
+
+  for (auto type : { studio::resources::compression_type::rle, studio::resources::compression_type::lz, studio::resources::compression_type::lzh })
+  {
+    const auto compressed = studio::resources::vol::darkstar::compress(nonstd::span<const std::byte>(input.data(), input.size()), type);
+
+    // The entry starts after some unrelated data, like it would in a volume.
+    auto volume = std::basic_string<std::byte>(100, std::byte{ 0xff }) + std::basic_string<std::byte>(compressed.data(), compressed.size());
+    std::basic_stringstream<std::byte> source(volume);
+
+    studio::resources::vol::darkstar::entry_stream entry(source, 100, studio::resources::vol::darkstar::seekable_decoder(type, compressed.size(), input.size(), 4096));
+
+    for (auto position : { 90000u, 70001u, 4095u, 0u, 99990u, 50000u })
+    {
+      std::basic_string<std::byte> actual(16, std::byte{});
+      entry.seekg(position);
+      entry.read(actual.data(), std::streamsize(actual.size()));
+
+      REQUIRE(actual.substr(0, std::size_t(entry.gcount())) == input.substr(position, 16));
+    }
+
+    // The first read buffers up to the end of the entry, which records every checkpoint along the way.
+    REQUIRE(entry.get_decoder().checkpoint_count() == (input.size() - 1) / 4096 + 1);
+  }
+}
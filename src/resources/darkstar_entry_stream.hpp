@@ -0,0 +1,129 @@
+#ifndef DARKSTARDTSCONVERTER_DARKSTAR_ENTRY_STREAM_HPP
+#define DARKSTARDTSCONVERTER_DARKSTAR_ENTRY_STREAM_HPP
+
+#include <array>
+#include <memory>
+#include <istream>
+#include <cstddef>
+#include "darkstar_compression.hpp"
+
+namespace studio::resources::vol::darkstar
+{
+  // A seekable stream buffer over a single volume entry, which only decodes the parts of it which are read.
+  class entry_buffer : public std::basic_streambuf<std::byte>
+  {
+  public:
+    entry_buffer(std::basic_istream<std::byte>& source, std::streamoff data_offset, seekable_decoder decoder)
+      : source(source), data_offset(data_offset), decoder(std::move(decoder))
+    {
+      setg(buffer.data(), buffer.data(), buffer.data());
+    }
+
+    const seekable_decoder& get_decoder() const
+    {
+      return decoder;
+    }
+
+  protected:
+    int_type underflow() override
+    {
+      if (gptr() < egptr())
+      {
+        return traits_type::to_int_type(*gptr());
+      }
+
+      buffer_position += std::size_t(egptr() - eback());
+
+      const auto count = decoder.read(source, data_offset, buffer_position, buffer.data(), buffer.size());
+      setg(buffer.data(), buffer.data(), buffer.data() + count);
+
+      return count > 0 ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+    }
+
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override
+    {
+      if (!(which & std::ios_base::in))
+      {
+        return pos_type(off_type(-1));
+      }
+
+      off_type base = off_type(buffer_position) + (gptr() - eback());
+
+      if (direction == std::ios_base::beg)
+      {
+        base = 0;
+      }
+      else if (direction == std::ios_base::end)
+      {
+        base = off_type(decoder.size());
+      }
+
+      const auto target = base + offset;
+
+      if (target < 0 || target > off_type(decoder.size()))
+      {
+        return pos_type(off_type(-1));
+      }
+
+      // Seeking within what has already been decoded keeps the buffer, anything else starts over from the target.
+      if (target >= off_type(buffer_position) && target <= off_type(buffer_position) + (egptr() - eback()))
+      {
+        setg(eback(), eback() + (target - off_type(buffer_position)), egptr());
+      }
+      else
+      {
+        buffer_position = std::size_t(target);
+        setg(buffer.data(), buffer.data(), buffer.data());
+      }
+
+      return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+    {
+      return seekoff(off_type(position), std::ios_base::beg, which);
+    }
+
+    std::streamsize showmanyc() override
+    {
+      const auto position = buffer_position + std::size_t(gptr() - eback());
+      return position < decoder.size() ? std::streamsize(decoder.size() - position) : -1;
+    }
+
+  private:
+    std::basic_istream<std::byte>& source;
+    std::streamoff data_offset;
+    seekable_decoder decoder;
+    std::size_t buffer_position = 0;
+    std::array<std::byte, 16384> buffer{};
+  };
+
+  // The volume stream has to outlive the entry stream, and shouldn't be used by anything else while it is being read.
+  class entry_stream : public std::basic_istream<std::byte>
+  {
+  public:
+    entry_stream(std::basic_istream<std::byte>& source, std::streamoff data_offset, seekable_decoder decoder)
+      : std::basic_istream<std::byte>(nullptr), buffer(source, data_offset, std::move(decoder))
+    {
+      rdbuf(&buffer);
+    }
+
+    // For an entry which is the only user of its volume stream.
+    entry_stream(std::unique_ptr<std::basic_istream<std::byte>> source, std::streamoff data_offset, seekable_decoder decoder)
+      : std::basic_istream<std::byte>(nullptr), owned_source(std::move(source)), buffer(*owned_source, data_offset, std::move(decoder))
+    {
+      rdbuf(&buffer);
+    }
+
+    const seekable_decoder& get_decoder() const
+    {
+      return buffer.get_decoder();
+    }
+
+  private:
+    std::unique_ptr<std::basic_istream<std::byte>> owned_source;
+    entry_buffer buffer;
+  };
+}// namespace studio::resources::vol::darkstar
+
+#endif//DARKSTARDTSCONVERTER_DARKSTAR_ENTRY_STREAM_HPP
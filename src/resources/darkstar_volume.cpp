@@ -4,134 +4,22 @@
 #include <array>
 #include <utility>
 #include <string>
-#include <cstdlib>
+#include <string_view>
+#include <algorithm>
 #include "resources/darkstar_volume.hpp"
+#include "resources/darkstar_volume_format.hpp"
+#include "resources/darkstar_compression.hpp"
 
 namespace studio::resources::vol::darkstar
 {
-  namespace endian = boost::endian;
-  using namespace std::literals;
-
-  // TODO add some checks for these items
-  constexpr auto vol_index_tag = "voli"sv;
-  constexpr auto vol_string_tag = "vols"sv;
-  constexpr auto vol_block_tag = "vblk"sv;
-
-  using file_tag = std::array<std::byte, 4>;
-
-  constexpr file_tag to_tag(const std::array<std::uint8_t, 4> values)
-  {
-    file_tag result{};
-
-    for (auto i = 0u; i < values.size(); i++)
-    {
-      result[i] = std::byte{ values[i] };
-    }
-    return result;
-  }
-
-  constexpr auto vol_file_tag = to_tag({ ' ', 'V', 'O', 'L' });
-  constexpr auto alt_vol_file_tag = to_tag({ 'P', 'V', 'O', 'L' });
-  constexpr auto old_vol_file_tag = to_tag({ 'V', 'O', 'L', ' ' });
-
-  enum class compression_type : std::uint8_t
-  {
-    none,
-    rle,
-    lz,
-    lzh
-  };
-
-  enum class volume_version
-  {
-    three_space_vol,
-    darkstar_pvol,
-    darkstar_vol
-  };
-
   struct file_info
   {
-    std::string filename;
+    std::string_view filename;
     std::uint32_t offset;
     std::uint32_t size;
     compression_type compression_type;
   };
 
-  struct volume_header
-  {
-    std::array<std::byte, 4> file_tag;
-    endian::little_uint32_t footer_offset;
-  };
-
-  struct old_volume_header
-  {
-    std::array<std::byte, 4> file_tag;
-    endian::little_uint24_t footer_offset;
-    std::byte padding;
-  };
-
-  static_assert(sizeof(volume_header) == sizeof(old_volume_header));
-
-  struct normal_footer
-  {
-    std::array<std::byte, 4> string_header_tag;
-    endian::little_uint32_t dummy2;
-    std::array<std::byte, 4> dummy3;
-    endian::little_uint32_t dummy4;
-    std::array<std::byte, 4> dummy5;
-    endian::little_uint32_t file_list_size;
-  };
-
-  struct alternative_footer
-  {
-    std::array<std::byte, 4> string_header_tag;
-    endian::little_uint32_t file_list_size;
-  };
-
-  struct old_footer
-  {
-    std::array<std::byte, 4> header_tag;
-    endian::little_uint24_t header_size;
-    std::byte padding;
-    std::array<std::byte, 4> string_header_tag;
-    endian::little_uint24_t buffer_size;
-    std::byte padding2;
-    endian::little_uint24_t file_list_size;
-    std::byte padding3;
-  };
-
-  static_assert(sizeof(alternative_footer) * 2 + sizeof(std::array<std::byte, 4>)
-                == sizeof(old_footer));
-
-  struct file_index_header
-  {
-    std::array<std::byte, 4> index_tag;
-    endian::little_uint32_t index_size;
-  };
-
-  struct file_header
-  {
-    endian::little_uint32_t id;
-    endian::little_uint32_t name_empty_space;
-    endian::little_uint32_t offset;
-    endian::little_uint32_t size;
-    compression_type compression_type;
-  };
-
-  static_assert(sizeof(file_header) == sizeof(std::array<std::byte, 17>));
-
-  struct old_file_header
-  {
-    endian::little_uint32_t id;
-    endian::little_uint32_t offset;
-    endian::little_uint32_t size;
-    std::uint8_t padding;
-    std::uint8_t compression_type;
-  };
-
-  static_assert(sizeof(old_file_header) == sizeof(std::array<std::byte, 14>));
-
-
   std::tuple<volume_version, std::size_t, std::optional<std::size_t>> get_file_list_offsets(std::basic_istream<std::byte>& raw_data)
   {
     volume_header header{};
@@ -169,7 +57,20 @@ namespace studio::resources::vol::darkstar
     }
   }
 
-  std::pair<volume_version, std::vector<std::string>> get_file_names(std::basic_istream<std::byte>& raw_data)
+  // The names of a volume all point into the one buffer they were read into.
+  struct file_names
+  {
+    std::vector<char> buffer;
+    std::vector<std::string_view> names;
+  };
+
+  struct volume_listing
+  {
+    std::vector<char> name_buffer;
+    std::vector<file_info> files;
+  };
+
+  std::pair<volume_version, file_names> get_file_names(std::basic_istream<std::byte>& raw_data)
   {
     auto [volume_type, buffer_size, amount_to_skip] = get_file_list_offsets(raw_data);
     std::vector<char> raw_chars(buffer_size);
@@ -181,13 +82,16 @@ namespace studio::resources::vol::darkstar
 
     raw_data.read(reinterpret_cast<std::byte*>(raw_chars.data()), raw_chars.size());
 
-    std::vector<std::string> results;
+    std::vector<std::string_view> results;
 
     std::size_t index = 0;
 
     while (index < raw_chars.size())
     {
-      results.emplace_back(raw_chars.data() + index);
+      const char* start = raw_chars.data() + index;
+      const char* end = std::find(start, start + (raw_chars.size() - index), '\0');
+
+      results.emplace_back(start, std::size_t(end - start));
 
       index += results.back().size() + 1;
     }
@@ -197,12 +101,13 @@ namespace studio::resources::vol::darkstar
       raw_data.seekg(amount_to_skip.value(), std::ios::cur);
     }
 
-    return std::make_pair(volume_type, results);
+    return std::make_pair(volume_type, file_names{ std::move(raw_chars), std::move(results) });
   }
 
-  std::vector<file_info> get_file_metadata(std::basic_istream<std::byte>& raw_data)
+  volume_listing get_file_metadata(std::basic_istream<std::byte>& raw_data)
   {
-    auto [volume_type, filenames] = get_file_names(raw_data);
+    auto [volume_type, names] = get_file_names(raw_data);
+    const auto& filenames = names.names;
     file_index_header header{};
 
     if (volume_type == volume_version::three_space_vol)
@@ -260,7 +165,7 @@ namespace studio::resources::vol::darkstar
 
       file_info info;
 
-      info.filename = std::move(filenames[results.size()]);
+      info.filename = filenames[results.size()];
       info.offset = offset;
       info.size = size;
       info.compression_type = compression_type;
@@ -272,7 +177,7 @@ namespace studio::resources::vol::darkstar
       }
     }
 
-    return results;
+    return volume_listing{ std::move(names.buffer), std::move(results) };
   }
 
   using folder_info = studio::resources::folder_info;
@@ -292,15 +197,25 @@ namespace studio::resources::vol::darkstar
     return is_supported(stream);
   }
 
+  std::vector<studio::resources::file_signature> vol_file_archive::get_signatures()
+  {
+    return { vol_file_tag, alt_vol_file_tag, old_vol_file_tag };
+  }
+
+  std::vector<studio::resources::file_signature> vol_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
   std::vector<vol_file_archive::content_info> vol_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
   {
     std::vector<vol_file_archive::content_info> results;
 
     auto raw_results = get_file_metadata(stream);
 
-    results.reserve(raw_results.size());
+    results.reserve(raw_results.files.size());
 
-    std::transform(raw_results.begin(), raw_results.end(), std::back_inserter(results), [&](const auto& value) {
+    std::transform(raw_results.files.begin(), raw_results.files.end(), std::back_inserter(results), [&](const auto& value) {
       studio::resources::file_info info{};
       info.filename = value.filename;
       info.offset = value.offset;
@@ -325,6 +240,17 @@ namespace studio::resources::vol::darkstar
     }
   }
 
+  // Positions the stream at the data of a compressed entry, and returns the size of that data.
+  std::size_t read_compressed_size(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info)
+  {
+    stream.seekg(info.offset, std::ios::beg);
+
+    file_index_header block_header{};
+    stream.read(reinterpret_cast<std::byte*>(&block_header), sizeof(block_header));
+
+    return block_header.index_size & block_size_mask;
+  }
+
   void vol_file_archive::extract_file_contents(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const
   {
     if (info.compression_type == studio::resources::compression_type::none)
@@ -336,53 +262,29 @@ namespace studio::resources::vol::darkstar
     }
     else
     {
-      std::stringstream command;
-
-      auto volume_filename = info.folder_path;
-
-      auto folder_path = volume_filename.parent_path() / "temp";
+      const auto compressed_size = read_compressed_size(stream, info);
 
-      auto new_path = folder_path / (info.filename.string() + ".tmp");
-
-      std::filesystem::create_directory(folder_path);
-
-      auto extract_path = std::filesystem::path("extract.exe");
-
-      if (std::filesystem::exists(std::filesystem::current_path() / extract_path))
-      {
-        extract_path = std::filesystem::current_path() / extract_path;
-      }
-      else if (std::filesystem::exists(volume_filename.parent_path() / extract_path))
-      {
-        extract_path = volume_filename.parent_path() / extract_path;
-      }
-
-      auto extract_path_str = extract_path.string();
-
-      if (extract_path_str.find(" ") != std::string::npos)
-      {
-        command << "cd /d " << extract_path.parent_path() << " && " << extract_path.filename().string()
-                << ' ' << volume_filename << ' ' << info.filename << ' ' << new_path;
-      }
-      else
-      {
-        command << extract_path.string() << ' ' << volume_filename << ' ' << info.filename << ' ' << new_path;
-      }
+      decompress(stream, compressed_size, info.size, info.compression_type, output);
+    }
+  }
 
-      std::system(command.str().c_str());
+  std::unique_ptr<entry_stream> vol_file_archive::open_entry(std::basic_istream<std::byte>& stream,
+    const studio::resources::file_info& info,
+    std::size_t checkpoint_interval)
+  {
+    const auto compressed_size = read_compressed_size(stream, info);
 
-      if (std::filesystem::exists(new_path) && std::filesystem::file_size(new_path) > info.size)
-      {
-        {
-          auto new_file = std::basic_ifstream<std::byte>{ new_path, std::ios::binary };
+    return std::make_unique<entry_stream>(stream,
+      std::streamoff(info.offset + sizeof(file_index_header)),
+      seekable_decoder(info.compression_type, compressed_size, info.size, checkpoint_interval));
+  }
 
-          std::copy_n(std::istreambuf_iterator<std::byte>(new_file),
-            info.size,
-            std::ostreambuf_iterator<std::byte>(output));
-        }
+  std::unique_ptr<std::basic_istream<std::byte>> vol_file_archive::open_compressed_entry(std::unique_ptr<std::basic_istream<std::byte>> stream, const studio::resources::file_info& info) const
+  {
+    const auto compressed_size = read_compressed_size(*stream, info);
 
-        std::filesystem::remove(new_path);
-      }
-    }
+    return std::make_unique<entry_stream>(std::move(stream),
+      std::streamoff(info.offset + sizeof(file_index_header)),
+      seekable_decoder(info.compression_type, compressed_size, info.size));
   }
 }// namespace darkstar::vol
\ No newline at end of file
@@ -5,9 +5,11 @@
 #include <vector>
 #include <fstream>
 #include <optional>
+#include <memory>
 #include <utility>
 
 #include "archive_plugin.hpp"
+#include "darkstar_entry_stream.hpp"
 #include "endian_arithmetic.hpp"
 
 namespace studio::resources::vol::darkstar
@@ -15,11 +17,20 @@ namespace studio::resources::vol::darkstar
   struct vol_file_archive : studio::resources::archive_plugin
   {
     static bool is_supported(std::basic_istream<std::byte>& stream);
+    static std::vector<studio::resources::file_signature> get_signatures();
 
     bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
     std::vector<content_info> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
     void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
     void extract_file_contents(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const override;
+    std::unique_ptr<std::basic_istream<std::byte>> open_compressed_entry(std::unique_ptr<std::basic_istream<std::byte>> stream, const studio::resources::file_info& info) const override;
+
+    // Opens an entry for random access, so that reading part of a compressed entry doesn't decode all of it.
+    // Seeking back only decodes from the nearest checkpoint recorded while reading forward.
+    static std::unique_ptr<entry_stream> open_entry(std::basic_istream<std::byte>& stream,
+      const studio::resources::file_info& info,
+      std::size_t checkpoint_interval = seekable_decoder::default_checkpoint_interval);
   };
 }// namespace darkstar::vol
 
@@ -0,0 +1,133 @@
+#ifndef DARKSTARDTSCONVERTER_DARKSTAR_VOLUME_FORMAT_HPP
+#define DARKSTARDTSCONVERTER_DARKSTAR_VOLUME_FORMAT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "endian_arithmetic.hpp"
+
+// The on disk layout of Darkstar volumes, shared by the reader and the writer.
+namespace studio::resources::vol::darkstar
+{
+  namespace endian = boost::endian;
+
+  using file_tag = std::array<std::byte, 4>;
+
+  constexpr file_tag to_tag(const std::array<std::uint8_t, 4> values)
+  {
+    file_tag result{};
+
+    for (auto i = 0u; i < values.size(); i++)
+    {
+      result[i] = std::byte{ values[i] };
+    }
+    return result;
+  }
+
+  constexpr auto vol_file_tag = to_tag({ ' ', 'V', 'O', 'L' });
+  constexpr auto alt_vol_file_tag = to_tag({ 'P', 'V', 'O', 'L' });
+  constexpr auto old_vol_file_tag = to_tag({ 'V', 'O', 'L', ' ' });
+
+  // TODO add some checks for these items
+  constexpr auto vol_index_tag = to_tag({ 'v', 'o', 'l', 'i' });
+  constexpr auto vol_string_tag = to_tag({ 'v', 'o', 'l', 's' });
+  constexpr auto vol_block_tag = to_tag({ 'v', 'b', 'l', 'k' });
+
+  // Marks a block which is no longer referred to by the index, after an in place update.
+  constexpr auto vol_dead_block_tag = to_tag({ 'v', 'd', 'e', 'd' });
+
+  enum class compression_type : std::uint8_t
+  {
+    none,
+    rle,
+    lz,
+    lzh
+  };
+
+  enum class volume_version
+  {
+    three_space_vol,
+    darkstar_pvol,
+    darkstar_vol
+  };
+
+  struct volume_header
+  {
+    std::array<std::byte, 4> file_tag;
+    endian::little_uint32_t footer_offset;
+  };
+
+  struct old_volume_header
+  {
+    std::array<std::byte, 4> file_tag;
+    endian::little_uint24_t footer_offset;
+    std::byte padding;
+  };
+
+  static_assert(sizeof(volume_header) == sizeof(old_volume_header));
+
+  struct normal_footer
+  {
+    std::array<std::byte, 4> string_header_tag;
+    endian::little_uint32_t dummy2;
+    std::array<std::byte, 4> dummy3;
+    endian::little_uint32_t dummy4;
+    std::array<std::byte, 4> dummy5;
+    endian::little_uint32_t file_list_size;
+  };
+
+  struct alternative_footer
+  {
+    std::array<std::byte, 4> string_header_tag;
+    endian::little_uint32_t file_list_size;
+  };
+
+  struct old_footer
+  {
+    std::array<std::byte, 4> header_tag;
+    endian::little_uint24_t header_size;
+    std::byte padding;
+    std::array<std::byte, 4> string_header_tag;
+    endian::little_uint24_t buffer_size;
+    std::byte padding2;
+    endian::little_uint24_t file_list_size;
+    std::byte padding3;
+  };
+
+  static_assert(sizeof(alternative_footer) * 2 + sizeof(std::array<std::byte, 4>)
+                == sizeof(old_footer));
+
+  struct file_index_header
+  {
+    std::array<std::byte, 4> index_tag;
+    endian::little_uint32_t index_size;
+  };
+
+  // The size of a block of entry data keeps a flag in its top bit, which is set when the data is compressed.
+  constexpr std::uint32_t compressed_block_flag = 0x80000000u;
+  constexpr std::uint32_t block_size_mask = 0x7fffffffu;
+
+  struct file_header
+  {
+    endian::little_uint32_t id;
+    endian::little_uint32_t name_empty_space;
+    endian::little_uint32_t offset;
+    endian::little_uint32_t size;
+    compression_type compression_type;
+  };
+
+  static_assert(sizeof(file_header) == sizeof(std::array<std::byte, 17>));
+
+  struct old_file_header
+  {
+    endian::little_uint32_t id;
+    endian::little_uint32_t offset;
+    endian::little_uint32_t size;
+    std::uint8_t padding;
+    std::uint8_t compression_type;
+  };
+
+  static_assert(sizeof(old_file_header) == sizeof(std::array<std::byte, 14>));
+}// namespace studio::resources::vol::darkstar
+
+#endif//DARKSTARDTSCONVERTER_DARKSTAR_VOLUME_FORMAT_HPP
@@ -0,0 +1,487 @@
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include "resources/darkstar_volume_writer.hpp"
+#include "resources/darkstar_volume.hpp"
+#include "resources/shared_file.hpp"
+#include "resources/file_handle_cache.hpp"
+#include "resources/darkstar_volume_format.hpp"
+#include "resources/darkstar_compression.hpp"
+#include "shared.hpp"
+
+namespace studio::resources::vol::darkstar
+{
+  namespace
+  {
+    struct index_record
+    {
+      std::string_view name;
+      std::uint32_t offset;
+      std::uint32_t size;
+      studio::resources::compression_type compression;
+    };
+
+    using output_function = std::function<void(const std::byte*, std::size_t)>;
+
+    template<typename ValueType>
+    void write_value(const output_function& output, const ValueType& value)
+    {
+      output(reinterpret_cast<const std::byte*>(&value), sizeof(value));
+    }
+
+    // Blocks are kept 4 byte aligned, like in the volumes shipped with the games.
+    constexpr std::size_t block_alignment = 4;
+    constexpr std::array<std::byte, block_alignment> padding{};
+
+    std::size_t padding_for(std::uint64_t size)
+    {
+      return std::size_t((block_alignment - size % block_alignment) % block_alignment);
+    }
+
+    std::uint64_t get_block_size(std::size_t stored_size)
+    {
+      return sizeof(file_index_header) + stored_size + padding_for(stored_size);
+    }
+
+    void write_block(const output_function& output, const std::byte* data, std::size_t size, studio::resources::compression_type compression)
+    {
+      const auto flag = compression == studio::resources::compression_type::none ? 0u : compressed_block_flag;
+
+      write_value(output, file_index_header{ vol_block_tag, std::uint32_t(size) | flag });
+      output(data, size);
+      output(padding.data(), padding_for(size));
+    }
+
+    std::string get_string_table(const std::vector<index_record>& records)
+    {
+      std::string names;
+
+      for (const auto& record : records)
+      {
+        names.append(record.name);
+        names.push_back('\0');
+      }
+
+      return names;
+    }
+
+    std::uint64_t get_footer_size(const std::vector<index_record>& records)
+    {
+      const auto names_size = get_string_table(records).size();
+      return sizeof(normal_footer) + names_size % 2 + names_size + sizeof(file_index_header) + records.size() * sizeof(file_header);
+    }
+
+    void check_volume_size(std::uint64_t size)
+    {
+      if (size > std::numeric_limits<std::uint32_t>::max())
+      {
+        throw std::invalid_argument("The contents of the volume do not fit into 4GB.");
+      }
+    }
+
+    void write_footer(const output_function& output, const std::vector<index_record>& records)
+    {
+      const auto names = get_string_table(records);
+
+      // The reader skips over the first two blocks of the footer, which are left empty.
+      write_value(output, normal_footer{ vol_string_tag, 0, vol_index_tag, 0, vol_string_tag, std::uint32_t(names.size()) });
+
+      // An odd sized string table is preceded by a padding byte.
+      output(padding.data(), names.size() % 2);
+      output(reinterpret_cast<const std::byte*>(names.data()), names.size());
+
+      write_value(output, file_index_header{ vol_index_tag, std::uint32_t(records.size() * sizeof(file_header)) });
+
+      std::uint32_t name_offset = 0;
+
+      for (auto i = 0u; i < records.size(); ++i)
+      {
+        const auto& record = records[i];
+        write_value(output, file_header{ i, name_offset, record.offset, record.size, vol::darkstar::compression_type(record.compression) });
+        name_offset += std::uint32_t(record.name.size() + 1);
+      }
+    }
+
+    void write_to_file(std::ostream& file, const std::byte* data, std::size_t size)
+    {
+      file.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+    }
+  }// namespace
+
+  void vol_writer::add_file(std::string name, std::vector<std::byte> data, studio::resources::compression_type compression)
+  {
+    auto key = studio::shared::to_lower(name);
+
+    if (auto existing = entry_indexes.find(key); existing != entry_indexes.end())
+    {
+      auto& value = entries[existing->second];
+      value.name = std::move(name);
+      value.data = std::move(data);
+      value.compression = compression;
+      return;
+    }
+
+    entry_indexes.emplace(std::move(key), entries.size());
+    entries.push_back(entry{ std::move(name), std::move(data), compression });
+  }
+
+  void vol_writer::add_file(const std::filesystem::path& path, studio::resources::compression_type compression)
+  {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+      throw std::invalid_argument("The file " + path.string() + " could not be opened.");
+    }
+
+    std::vector<std::byte> data(std::size_t(std::filesystem::file_size(path)));
+    file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size()));
+
+    add_file(path.filename().string(), std::move(data), compression);
+  }
+
+  bool vol_writer::remove_file(const std::string& name)
+  {
+    auto existing = entry_indexes.find(studio::shared::to_lower(name));
+
+    if (existing == entry_indexes.end())
+    {
+      return false;
+    }
+
+    entries.erase(entries.begin() + existing->second);
+    entry_indexes.clear();
+
+    for (auto i = 0u; i < entries.size(); ++i)
+    {
+      entry_indexes.emplace(studio::shared::to_lower(entries[i].name), i);
+    }
+
+    return true;
+  }
+
+  std::size_t vol_writer::size() const
+  {
+    return entries.size();
+  }
+
+  void vol_writer::write(std::basic_ostream<std::byte>& output, studio::resources::task_pool& pool) const
+  {
+    write([&](const std::byte* data, std::size_t size) { output.write(data, std::streamsize(size)); }, pool);
+  }
+
+  void vol_writer::write(const std::filesystem::path& path, studio::resources::task_pool& pool) const
+  {
+    std::ofstream output(path, std::ios::binary);
+
+    write([&](const std::byte* data, std::size_t size) { write_to_file(output, data, size); }, pool);
+
+    if (!output)
+    {
+      throw std::invalid_argument("The volume " + path.string() + " could not be written.");
+    }
+  }
+
+  std::vector<vol_writer::stored_block> vol_writer::encode(studio::resources::task_pool& pool) const
+  {
+    std::vector<stored_block> blocks(entries.size());
+
+    studio::resources::task_group group(pool);
+
+    for (auto i = 0u; i < entries.size(); ++i)
+    {
+      blocks[i].compression = studio::resources::compression_type::none;
+
+      if (entries[i].compression == studio::resources::compression_type::none)
+      {
+        continue;
+      }
+
+      group.run([&, i] {
+        const auto& value = entries[i];
+        auto compressed = compress(nonstd::span<const std::byte>(value.data.data(), value.data.size()), value.compression);
+
+        if (compressed.size() < value.data.size())
+        {
+          blocks[i] = stored_block{ std::move(compressed), value.compression };
+        }
+      });
+    }
+
+    group.wait();
+
+    return blocks;
+  }
+
+  const std::vector<std::byte>& vol_writer::get_stored_data(const std::vector<stored_block>& blocks, std::size_t index) const
+  {
+    return blocks[index].compression == studio::resources::compression_type::none ? entries[index].data : blocks[index].compressed;
+  }
+
+  void vol_writer::write(const output_function& output, studio::resources::task_pool& pool) const
+  {
+    const auto blocks = encode(pool);
+
+    // Every offset is known before anything is written, so the header can point straight at the footer.
+    std::vector<index_record> records;
+    records.reserve(entries.size());
+
+    std::uint64_t position = sizeof(volume_header);
+
+    for (auto i = 0u; i < entries.size(); ++i)
+    {
+      records.push_back(index_record{ entries[i].name, std::uint32_t(position), std::uint32_t(entries[i].data.size()), blocks[i].compression });
+      position += get_block_size(get_stored_data(blocks, i).size());
+      check_volume_size(position);
+    }
+
+    check_volume_size(position + get_footer_size(records));
+
+    write_value(output, volume_header{ vol_file_tag, std::uint32_t(position) });
+
+    for (auto i = 0u; i < entries.size(); ++i)
+    {
+      const auto& data = get_stored_data(blocks, i);
+      write_block(output, data.data(), data.size(), blocks[i].compression);
+    }
+
+    write_footer(output, records);
+  }
+
+  vol_updater::vol_updater(std::filesystem::path volume_path) : volume_path(std::move(volume_path))
+  {
+    load();
+  }
+
+  void vol_updater::load()
+  {
+    auto file = std::make_shared<studio::resources::shared_file>(volume_path);
+
+    volume_header header{};
+    file->read_at(0, reinterpret_cast<std::byte*>(&header), sizeof(header));
+
+    if (header.file_tag != vol_file_tag)
+    {
+      throw std::invalid_argument("Only Darkstar volumes starting with \" VOL\" can be updated in place.");
+    }
+
+    footer_offset = header.footer_offset;
+
+    studio::resources::file_range_stream stream(file, 0, file->size());
+    auto listing = vol_file_archive().get_content_listing(stream, volume_path);
+
+    entries.clear();
+    entries.reserve(listing.size());
+
+    std::uint64_t used_bytes = sizeof(volume_header);
+
+    for (const auto& item : listing)
+    {
+      const auto& info = std::get<studio::resources::file_info>(item);
+
+      file_index_header block_header{};
+      file->read_at(info.offset, reinterpret_cast<std::byte*>(&block_header), sizeof(block_header));
+
+      const auto stored_size = block_header.index_size & block_size_mask;
+
+      entries.push_back(entry{ info.filename.string(), std::uint32_t(info.offset), std::uint32_t(info.size), stored_size, info.compression_type });
+      used_bytes += get_block_size(stored_size);
+    }
+
+    dead_bytes = footer_offset > used_bytes ? footer_offset - used_bytes : 0;
+  }
+
+  void vol_updater::add_file(std::string name, std::vector<std::byte> data, studio::resources::compression_type compression)
+  {
+    removed.erase(studio::shared::to_lower(name));
+    pending.add_file(std::move(name), std::move(data), compression);
+  }
+
+  void vol_updater::remove_file(const std::string& name)
+  {
+    pending.remove_file(name);
+    removed.emplace(studio::shared::to_lower(name));
+  }
+
+  void vol_updater::commit(studio::resources::task_pool& pool)
+  {
+    if (pending.size() == 0 && removed.empty())
+    {
+      return;
+    }
+
+    const auto blocks = pending.encode(pool);
+
+    // Replaced entries keep their place in the index, and new ones are added after the existing ones.
+    std::vector<entry> updated;
+    updated.reserve(entries.size() + pending.size());
+
+    std::vector<std::size_t> slots(pending.size(), std::numeric_limits<std::size_t>::max());
+    std::vector<std::uint32_t> dead_offsets;
+
+    for (const auto& existing : entries)
+    {
+      const auto key = studio::shared::to_lower(existing.name);
+
+      if (auto replacement = pending.entry_indexes.find(key); replacement != pending.entry_indexes.end())
+      {
+        slots[replacement->second] = updated.size();
+        updated.push_back(existing);
+      }
+      else if (removed.find(key) == removed.end())
+      {
+        updated.push_back(existing);
+        continue;
+      }
+
+      dead_offsets.push_back(existing.offset);
+      dead_bytes += get_block_size(existing.stored_size);
+    }
+
+    for (auto& slot : slots)
+    {
+      if (slot == std::numeric_limits<std::size_t>::max())
+      {
+        slot = updated.size();
+        updated.emplace_back();
+      }
+    }
+
+    const auto file_size = std::filesystem::file_size(volume_path);
+    auto position = file_size + padding_for(file_size);
+
+    for (auto i = 0u; i < pending.entries.size(); ++i)
+    {
+      const auto& value = pending.entries[i];
+      updated[slots[i]] = entry{ value.name, std::uint32_t(position), std::uint32_t(value.data.size()), std::uint32_t(pending.get_stored_data(blocks, i).size()), blocks[i].compression };
+      position += get_block_size(pending.get_stored_data(blocks, i).size());
+      check_volume_size(position);
+    }
+
+    std::vector<index_record> records;
+    records.reserve(updated.size());
+
+    for (const auto& value : updated)
+    {
+      records.push_back(index_record{ value.name, value.offset, value.size, value.compression });
+    }
+
+    check_volume_size(position + get_footer_size(records));
+
+    std::fstream file(volume_path, std::ios::binary | std::ios::in | std::ios::out);
+    const auto output = [&](const std::byte* data, std::size_t size) { write_to_file(file, data, size); };
+
+    // The old header stays valid until the new blocks and index are completely written.
+    file.seekp(std::streamoff(file_size));
+    output(padding.data(), padding_for(file_size));
+
+    for (auto i = 0u; i < pending.entries.size(); ++i)
+    {
+      const auto& data = pending.get_stored_data(blocks, i);
+      write_block(output, data.data(), data.size(), blocks[i].compression);
+    }
+
+    write_footer(output, records);
+    file.flush();
+
+    file.seekp(0);
+    write_value(output, volume_header{ vol_file_tag, std::uint32_t(position) });
+    file.flush();
+
+    for (auto offset : dead_offsets)
+    {
+      file.seekp(offset);
+      output(vol_dead_block_tag.data(), vol_dead_block_tag.size());
+    }
+
+    file.close();
+
+    // Cached handles would otherwise keep reading the volume with the size it had when they were opened.
+    studio::resources::invalidate_file_handles(volume_path);
+
+    if (!file)
+    {
+      throw std::invalid_argument("The volume " + volume_path.string() + " could not be updated.");
+    }
+
+    // The old index and any alignment before the new blocks are no longer used either.
+    dead_bytes += file_size - footer_offset + padding_for(file_size);
+
+    footer_offset = std::uint32_t(position);
+    entries = std::move(updated);
+    pending = vol_writer{};
+    removed.clear();
+  }
+
+  void vol_updater::compact(studio::resources::task_pool& pool)
+  {
+    commit(pool);
+
+    if (dead_bytes == 0)
+    {
+      return;
+    }
+
+    auto temp_path = volume_path;
+    temp_path += ".tmp";
+
+    {
+      studio::resources::shared_file source(volume_path);
+      std::ofstream file(temp_path, std::ios::binary);
+      const auto output = [&](const std::byte* data, std::size_t size) { write_to_file(file, data, size); };
+
+      std::vector<index_record> records;
+      records.reserve(entries.size());
+
+      std::uint64_t position = sizeof(volume_header);
+
+      for (const auto& value : entries)
+      {
+        records.push_back(index_record{ value.name, std::uint32_t(position), value.size, value.compression });
+        position += get_block_size(value.stored_size);
+      }
+
+      write_value(output, volume_header{ vol_file_tag, std::uint32_t(position) });
+
+      // Blocks are copied as they are, so nothing has to be compressed again.
+      std::vector<std::byte> buffer;
+
+      for (const auto& value : entries)
+      {
+        buffer.resize(value.stored_size);
+        source.read_at(value.offset + sizeof(file_index_header), buffer.data(), buffer.size());
+        write_block(output, buffer.data(), buffer.size(), value.compression);
+      }
+
+      write_footer(output, records);
+
+      if (!file)
+      {
+        throw std::invalid_argument("The volume " + temp_path.string() + " could not be written.");
+      }
+    }
+
+    // Handles which are still open would keep the old volume alive, and on Windows stop it from being replaced.
+    studio::resources::invalidate_file_handles(volume_path);
+    std::filesystem::rename(temp_path, volume_path);
+    load();
+  }
+
+  std::uint64_t vol_updater::get_dead_bytes() const
+  {
+    return dead_bytes;
+  }
+
+  std::vector<std::string> vol_updater::get_file_names() const
+  {
+    std::vector<std::string> results;
+    results.reserve(entries.size());
+
+    for (const auto& value : entries)
+    {
+      results.push_back(value.name);
+    }
+
+    return results;
+  }
+}// namespace studio::resources::vol::darkstar
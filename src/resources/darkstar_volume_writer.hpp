@@ -0,0 +1,109 @@
+#ifndef DARKSTARDTSCONVERTER_DARKSTAR_VOLUME_WRITER_HPP
+#define DARKSTARDTSCONVERTER_DARKSTAR_VOLUME_WRITER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include "archive_plugin.hpp"
+#include "task_pool.hpp"
+
+namespace studio::resources::vol::darkstar
+{
+  // Builds a " VOL" volume, which can be read back with vol_file_archive.
+  // Entries are compressed in parallel, then the volume is written out in one sequential pass.
+  class vol_writer
+  {
+  public:
+    // Entries keep the order they were first added in. Adding a name again replaces the contents of the earlier entry.
+    void add_file(std::string name, std::vector<std::byte> data, studio::resources::compression_type compression = studio::resources::compression_type::none);
+
+    void add_file(const std::filesystem::path& path, studio::resources::compression_type compression = studio::resources::compression_type::none);
+
+    bool remove_file(const std::string& name);
+
+    std::size_t size() const;
+
+    // Entries which don't get any smaller with their compression are stored as they are.
+    void write(std::basic_ostream<std::byte>& output, studio::resources::task_pool& pool = studio::resources::task_pool::shared()) const;
+
+    void write(const std::filesystem::path& path, studio::resources::task_pool& pool = studio::resources::task_pool::shared()) const;
+
+  private:
+    friend class vol_updater;
+
+    struct entry
+    {
+      std::string name;
+      std::vector<std::byte> data;
+      studio::resources::compression_type compression;
+    };
+
+    // The bytes which end up in the block of an entry, which refer to the original data when it is stored uncompressed.
+    struct stored_block
+    {
+      std::vector<std::byte> compressed;
+      studio::resources::compression_type compression;
+    };
+
+    std::vector<stored_block> encode(studio::resources::task_pool& pool) const;
+
+    const std::vector<std::byte>& get_stored_data(const std::vector<stored_block>& blocks, std::size_t index) const;
+
+    void write(const std::function<void(const std::byte*, std::size_t)>& output, studio::resources::task_pool& pool) const;
+
+    std::vector<entry> entries;
+    std::unordered_map<std::string, std::size_t> entry_indexes;
+  };
+
+  // Changes an existing " VOL" volume in place. New and replaced entries are appended to the end of the volume,
+  // followed by a new string table and index, and only then is the header pointed at them.
+  // Blocks which are no longer used are tagged as dead and left where they are until the volume is compacted.
+  class vol_updater
+  {
+  public:
+    explicit vol_updater(std::filesystem::path volume_path);
+
+    void add_file(std::string name, std::vector<std::byte> data, studio::resources::compression_type compression = studio::resources::compression_type::none);
+
+    void remove_file(const std::string& name);
+
+    // Writes all pending changes, with I/O proportional to the size of the changed entries and the index.
+    void commit(studio::resources::task_pool& pool = studio::resources::task_pool::shared());
+
+    // Rewrites the volume without any dead blocks. Pending changes are committed first.
+    void compact(studio::resources::task_pool& pool = studio::resources::task_pool::shared());
+
+    // The bytes taken up by blocks and old indexes which are no longer used.
+    std::uint64_t get_dead_bytes() const;
+
+    std::vector<std::string> get_file_names() const;
+
+  private:
+    struct entry
+    {
+      std::string name;
+      std::uint32_t offset;
+      std::uint32_t size;
+      std::uint32_t stored_size;
+      studio::resources::compression_type compression;
+    };
+
+    void load();
+
+    std::filesystem::path volume_path;
+    std::vector<entry> entries;
+
+    vol_writer pending;
+    std::unordered_set<std::string> removed;
+
+    std::uint32_t footer_offset = 0;
+    std::uint64_t dead_bytes = 0;
+  };
+}// namespace studio::resources::vol::darkstar
+
+#endif//DARKSTARDTSCONVERTER_DARKSTAR_VOLUME_WRITER_HPP
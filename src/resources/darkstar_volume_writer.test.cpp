@@ -0,0 +1,211 @@
+#include <catch2/catch.hpp>
+#include <map>
+#include <cstring>
+#include <string>
+#include "darkstar_volume_writer.hpp"
+#include "darkstar_volume.hpp"
+#include "darkstar_volume_format.hpp"
+#include "resource_explorer.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+TEST_CASE("Written volumes are read back with the same contents", "[vol.darkstar]")
+{
+  const auto folder = make_test_folder("vol-writer");
+
+  std::string repeated;
+
+  for (auto i = 0; i < 500; ++i)
+  {
+    repeated += "terrain texture " + std::to_string(i % 7) + "\n";
+  }
+
+  studio::resources::vol::darkstar::vol_writer writer;
+  writer.add_file("plain.txt", to_bytes("stored as it is"));
+  writer.add_file("rle.bin", to_bytes(std::string(1000, 'x')), studio::resources::compression_type::rle);
+  writer.add_file("lz.txt", to_bytes(repeated), studio::resources::compression_type::lz);
+  writer.add_file("lzh.txt", to_bytes("replaced"), studio::resources::compression_type::lzh);
+  writer.add_file("LZH.txt", to_bytes(repeated + repeated), studio::resources::compression_type::lzh);
+
+  REQUIRE(writer.size() == 4);
+
+  writer.write(folder / "test.vol");
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::darkstar::vol_file_archive>());
+
+  auto files = explorer.find_files(folder / "test.vol", { "ALL" });
+  REQUIRE(files.size() == 4);
+
+  const std::map<std::string, std::string> expected{
+    { "plain.txt", "stored as it is" },
+    { "rle.bin", std::string(1000, 'x') },
+    { "lz.txt", repeated },
+    { "LZH.txt", repeated + repeated }
+  };
+
+  for (const auto& file : files)
+  {
+    auto stream = explorer.load_file(file);
+
+    std::string contents(file.size, '\0');
+    stream.second->read(reinterpret_cast<std::byte*>(contents.data()), std::streamsize(contents.size()));
+
+    REQUIRE(contents == expected.at(file.filename.string()));
+  }
+
+  REQUIRE(files[0].compression_type == studio::resources::compression_type::none);
+  REQUIRE(files[3].compression_type == studio::resources::compression_type::lzh);
+}
+
+TEST_CASE("Volumes are updated in place and compacted", "[vol.darkstar]")
+{
+  const auto folder = make_test_folder("vol-updater");
+
+  const auto volume_path = folder / "update.vol";
+
+  studio::resources::vol::darkstar::vol_writer writer;
+  writer.add_file("keep.txt", to_bytes(std::string(4000, 'k')));
+  writer.add_file("replace.txt", to_bytes(std::string(4000, 'r')), studio::resources::compression_type::lz);
+  writer.add_file("remove.txt", to_bytes(std::string(4000, 'x')));
+  writer.write(volume_path);
+
+  const auto original_size = std::filesystem::file_size(volume_path);
+
+  studio::resources::vol::darkstar::vol_updater updater(volume_path);
+  REQUIRE(updater.get_dead_bytes() == 0);
+
+  updater.add_file("replace.txt", to_bytes("new contents"));
+  updater.add_file("added.txt", to_bytes("added"));
+  updater.remove_file("remove.txt");
+  updater.commit();
+
+  // Only the new blocks and the index were appended.
+  REQUIRE(std::filesystem::file_size(volume_path) < original_size + 200);
+  REQUIRE(updater.get_dead_bytes() > 4000);
+  REQUIRE(updater.get_file_names() == std::vector<std::string>{ "keep.txt", "replace.txt", "added.txt" });
+
+  auto read_all = [&] {
+    studio::resources::resource_explorer explorer(folder);
+    explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::darkstar::vol_file_archive>());
+
+    std::map<std::string, std::string> results;
+
+    for (const auto& file : explorer.find_files(volume_path, { "ALL" }))
+    {
+      auto stream = explorer.load_file(file);
+      std::string contents(file.size, '\0');
+      stream.second->read(reinterpret_cast<std::byte*>(contents.data()), std::streamsize(contents.size()));
+      results.emplace(file.filename.string(), contents);
+    }
+
+    return results;
+  };
+
+  const std::map<std::string, std::string> expected{
+    { "keep.txt", std::string(4000, 'k') },
+    { "replace.txt", "new contents" },
+    { "added.txt", "added" }
+  };
+
+  REQUIRE(read_all() == expected);
+
+  updater.compact();
+
+  REQUIRE(updater.get_dead_bytes() == 0);
+  REQUIRE(std::filesystem::file_size(volume_path) < original_size);
+  REQUIRE(read_all() == expected);
+}
+
+TEST_CASE("Compressed entries too large to be cached are loaded as streams which decode as they are read", "[vol.darkstar]")
+{
+  const auto folder = make_test_folder("vol-entry-stream");
+
+  std::string repeated;
+
+  for (auto i = 0; i < 20000; ++i)
+  {
+    repeated += "mission object " + std::to_string(i % 13) + "\n";
+  }
+
+  studio::resources::vol::darkstar::vol_writer writer;
+  writer.add_file("objects.txt", to_bytes(repeated), studio::resources::compression_type::lzh);
+  writer.add_file("small.txt", to_bytes(repeated.substr(0, 1000)), studio::resources::compression_type::lzh);
+  writer.write(folder / "objects.vol");
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::darkstar::vol_file_archive>());
+  explorer.set_entry_cache_budget(64 * 1024);
+
+  const auto files = explorer.find_files(folder / "objects.vol", { "ALL" });
+  REQUIRE(files.size() == 2);
+
+  // Entries which fit into the cache are decoded once and shared.
+  for (auto i = 0; i < 2; ++i)
+  {
+    auto small = explorer.load_file(files[1]);
+    REQUIRE(dynamic_cast<studio::resources::vol::darkstar::entry_stream*>(small.second.get()) == nullptr);
+  }
+
+  REQUIRE(explorer.get_entry_cache_statistics().hits == 1);
+
+  auto stream = explorer.load_file(files[0]);
+  auto* entry = dynamic_cast<studio::resources::vol::darkstar::entry_stream*>(stream.second.get());
+  REQUIRE(entry != nullptr);
+
+  std::string header(16, '\0');
+  entry->read(reinterpret_cast<std::byte*>(header.data()), std::streamsize(header.size()));
+  REQUIRE(header == repeated.substr(0, 16));
+
+  // Only the start of the entry has been decoded so far.
+  REQUIRE(entry->get_decoder().checkpoint_count() <= 1);
+
+  entry->seekg(std::streamoff(repeated.size() - 16));
+  entry->read(reinterpret_cast<std::byte*>(header.data()), std::streamsize(header.size()));
+  REQUIRE(header == repeated.substr(repeated.size() - 16));
+
+  REQUIRE(explorer.get_entry_cache_statistics().misses == 1);
+}
+
+TEST_CASE("Compressed blocks are flagged in their block headers", "[vol.darkstar]")
+{
+  const auto folder = make_test_folder("vol-block-flags");
+  const auto volume_path = folder / "flags.vol";
+
+  studio::resources::vol::darkstar::vol_writer writer;
+  writer.add_file("plain.txt", to_bytes(std::string(4000, 'p')));
+  writer.add_file("packed.txt", to_bytes(std::string(4000, 'c')), studio::resources::compression_type::lz);
+  writer.add_file("removed.txt", to_bytes(std::string(4000, 'r')));
+  writer.write(volume_path);
+
+  auto check_flags = [&](std::size_t expected_count) {
+    studio::resources::resource_explorer explorer(folder);
+    explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::darkstar::vol_file_archive>());
+
+    const auto volume = read_file(volume_path);
+    const auto files = explorer.find_files(volume_path, { "ALL" });
+    REQUIRE(files.size() == expected_count);
+
+    for (const auto& file : files)
+    {
+      studio::resources::vol::darkstar::file_index_header header{};
+      std::memcpy(&header, volume.data() + file.offset, sizeof(header));
+
+      REQUIRE(header.index_tag == studio::resources::vol::darkstar::vol_block_tag);
+      REQUIRE(bool(header.index_size & studio::resources::vol::darkstar::compressed_block_flag) == (file.compression_type != studio::resources::compression_type::none));
+    }
+  };
+
+  check_flags(3);
+
+  studio::resources::vol::darkstar::vol_updater updater(volume_path);
+  updater.remove_file("removed.txt");
+  updater.add_file("added.txt", to_bytes(std::string(4000, 'a')), studio::resources::compression_type::lzh);
+  updater.commit();
+  check_flags(3);
+
+  // Compacting copies the blocks, which has to keep their flags.
+  updater.compact();
+  check_flags(3);
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <iterator>
+#include "resources/duplicate_finder.hpp"
+#include "resources/content_hash.hpp"
+#include "resources/memory_stream.hpp"
+
+namespace studio::resources
+{
+  duplicate_finder::duplicate_finder(studio::resources::task_pool& pool)
+    : pool(pool)
+  {
+  }
+
+  void duplicate_finder::add_entries(const studio::resources::resource_explorer& explorer, const std::vector<studio::resources::file_info>& entries)
+  {
+    auto archives = studio::resources::resource_explorer::group_by_archive(entries);
+
+    // Every task has its own results, so that nothing has to be locked while hashing.
+    struct archive_results
+    {
+      std::vector<hashed_entry> entries;
+      std::vector<failure> failures;
+    };
+
+    std::vector<archive_results> results(archives.size());
+
+    {
+      studio::resources::task_group hashers(pool);
+      auto current = results.begin();
+
+      for (auto& archive : archives)
+      {
+        hashers.run([&explorer, &archive, &archive_result = *current] {
+          try
+          {
+            hash_archive(explorer, archive.first, std::move(archive.second), archive_result.entries, archive_result.failures);
+          }
+          catch (const std::exception& error)
+          {
+            archive_result.failures.push_back({ archive.first, error.what() });
+          }
+        });
+
+        ++current;
+      }
+
+      hashers.wait();
+    }
+
+    for (auto& archive : results)
+    {
+      std::move(archive.entries.begin(), archive.entries.end(), std::back_inserter(hashed));
+      std::move(archive.failures.begin(), archive.failures.end(), std::back_inserter(failures));
+    }
+  }
+
+  duplicate_finder::report duplicate_finder::get_report() const
+  {
+    report result{};
+    result.files_hashed = hashed.size();
+    result.failures = failures;
+
+    for (const auto& entry : hashed)
+    {
+      result.bytes_hashed += entry.size;
+    }
+
+    // Entries are grouped when both the size and hash match, without comparing their bytes. A stable sort keeps each group in the order entries were added.
+    std::vector<const hashed_entry*> sorted(hashed.size());
+    std::transform(hashed.begin(), hashed.end(), sorted.begin(), [](const auto& entry) { return &entry; });
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+      return a->size != b->size ? a->size < b->size : a->hash < b->hash;
+    });
+
+    for (auto begin = sorted.begin(); begin != sorted.end();)
+    {
+      auto end = std::find_if(begin, sorted.end(), [&](const auto* entry) {
+        return entry->size != (*begin)->size || entry->hash != (*begin)->hash;
+      });
+
+      if (std::distance(begin, end) > 1)
+      {
+        auto& group = result.groups.emplace_back(duplicate_group{ (*begin)->hash, (*begin)->size, {} });
+        std::transform(begin, end, std::back_inserter(group.entries), [](const auto* entry) { return entry->info; });
+        result.redundant_bytes += group.get_redundant_bytes();
+      }
+
+      begin = end;
+    }
+
+    std::stable_sort(result.groups.begin(), result.groups.end(), [](const auto& a, const auto& b) {
+      return a.get_redundant_bytes() > b.get_redundant_bytes();
+    });
+
+    return result;
+  }
+
+  void duplicate_finder::hash_archive(const studio::resources::resource_explorer& explorer,
+    const std::filesystem::path& archive_path,
+    std::vector<studio::resources::file_info> entries,
+    std::vector<hashed_entry>& results,
+    std::vector<failure>& failures)
+  {
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+      return a.offset < b.offset;
+    });
+
+    // Only needed for compressed entries, which loose files never are.
+    std::optional<std::reference_wrapper<studio::resources::archive_plugin>> archive;
+    std::unique_ptr<std::basic_istream<std::byte>> archive_file;
+    std::vector<std::byte> buffer;
+
+    for (auto& entry : entries)
+    {
+      if (entry.size == 0)
+      {
+        continue;
+      }
+
+      if (entry.compression_type == studio::resources::compression_type::none)
+      {
+        auto view = explorer.load_file_view(entry);
+
+        if (!view.has_value())
+        {
+          failures.push_back({ entry.folder_path / entry.filename, "could not be read" });
+          continue;
+        }
+
+        // Views stop at the end of the file, so a short one means the archive is truncated.
+        if (view->data.size() != entry.size)
+        {
+          failures.push_back({ entry.folder_path / entry.filename, "is truncated" });
+          continue;
+        }
+
+        results.push_back({ studio::resources::hash_content(view->data), view->data.size(), std::move(entry) });
+        continue;
+      }
+
+      if (!archive_file)
+      {
+        archive = explorer.get_archive_type(archive_path);
+
+        if (!archive.has_value())
+        {
+          failures.push_back({ archive_path, "is not a supported archive" });
+          return;
+        }
+
+        archive_file = std::move(explorer.load_file(archive_path).second);
+      }
+
+      buffer.clear();
+
+      // A damaged entry is reported on its own, and the rest of the archive is still hashed.
+      try
+      {
+        studio::resources::vector_stream output(buffer);
+        archive->get().extract_file_contents(*archive_file, entry, output);
+      }
+      catch (const std::exception& error)
+      {
+        failures.push_back({ entry.folder_path / entry.filename, error.what() });
+        archive_file->clear();
+        continue;
+      }
+
+      results.push_back({ studio::resources::hash_content(buffer), buffer.size(), std::move(entry) });
+    }
+  }
+}// namespace studio::resources
@@ -0,0 +1,78 @@
+#ifndef DARKSTARDTSCONVERTER_DUPLICATE_FINDER_HPP
+#define DARKSTARDTSCONVERTER_DUPLICATE_FINDER_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "resource_explorer.hpp"
+#include "task_pool.hpp"
+
+namespace studio::resources
+{
+  // Finds entries whose contents have the same size and XXH64 hash, across any number of archives and folders.
+  // Entries are never compared byte for byte, so a group is a hash match rather than proof that the contents are the same.
+  // Each archive is hashed by its own task. Uncompressed entries are hashed where they are, through a view of the archive,
+  // and compressed ones are decoded into a buffer which is reused for the whole archive.
+  class duplicate_finder
+  {
+  public:
+    struct failure
+    {
+      std::filesystem::path path;
+      std::string message;
+    };
+
+    struct duplicate_group
+    {
+      std::uint64_t hash;
+      std::uint64_t size;
+      std::vector<studio::resources::file_info> entries;
+
+      // What keeping a single copy of the contents would save.
+      std::uint64_t get_redundant_bytes() const
+      {
+        return size * (entries.size() - 1);
+      }
+    };
+
+    struct report
+    {
+      // Ordered by the bytes they could save, largest first.
+      std::vector<duplicate_group> groups;
+      std::size_t files_hashed;
+      std::uint64_t bytes_hashed;
+      std::uint64_t redundant_bytes;
+      std::vector<failure> failures;
+    };
+
+    explicit duplicate_finder(studio::resources::task_pool& pool = studio::resources::task_pool::shared());
+
+    // Entries of several explorers can be added one after another, and are all compared with each other.
+    // Empty entries are left out, since there is nothing to be saved by removing them.
+    void add_entries(const studio::resources::resource_explorer& explorer, const std::vector<studio::resources::file_info>& entries);
+
+    report get_report() const;
+
+  private:
+    struct hashed_entry
+    {
+      std::uint64_t hash;
+      std::uint64_t size;
+      studio::resources::file_info info;
+    };
+
+    static void hash_archive(const studio::resources::resource_explorer& explorer,
+      const std::filesystem::path& archive_path,
+      std::vector<studio::resources::file_info> entries,
+      std::vector<hashed_entry>& results,
+      std::vector<failure>& failures);
+
+    studio::resources::task_pool& pool;
+    std::vector<hashed_entry> hashed;
+    std::vector<failure> failures;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_DUPLICATE_FINDER_HPP
@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include "duplicate_finder.hpp"
+#include "content_hash.hpp"
+#include "three_space_volume.hpp"
+#include "zip_archive.hpp"
+#include "crc32.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+namespace
+{
+  std::uint64_t hash_text(std::string_view text)
+  {
+    return studio::resources::hash_content(nonstd::span<const std::byte>(reinterpret_cast<const std::byte*>(text.data()), text.size()));
+  }
+}// namespace
+
+TEST_CASE("Content hashes match the reference implementation", "[resources]")
+{
+  REQUIRE(hash_text("") == 0xef46db3751d8e999ull);
+  REQUIRE(hash_text("a") == 0xd24ec4f1a98c6e5bull);
+  REQUIRE(hash_text("abc") == 0x44bc2cf5ad770999ull);
+  REQUIRE(hash_text("The quick brown fox jumps over the lazy dog") == 0x0b242d361fda71bcull);
+}
+
+TEST_CASE("Identical entries are grouped across volumes and folders", "[resources]")
+{
+  const auto folder = make_test_folder("duplicates");
+
+  for (auto name : { "one.vol", "two.vol" })
+  {
+    write_file(folder / name, two_entry_volume);
+  }
+
+  write_file(folder / "loose.txt", "cde");
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+
+  studio::resources::duplicate_finder finder;
+  finder.add_entries(explorer, explorer.find_files({ ".txt" }));
+  const auto result = finder.get_report();
+
+  REQUIRE(result.failures.empty());
+  REQUIRE(result.files_hashed == 5);
+  REQUIRE(result.groups.size() == 2);
+
+  REQUIRE(result.groups[0].size == 3);
+  REQUIRE(result.groups[0].entries.size() == 3);
+  REQUIRE(result.groups[1].size == 2);
+  REQUIRE(result.groups[1].entries.size() == 2);
+  REQUIRE(result.redundant_bytes == 3 * 2 + 2);
+}
+
+TEST_CASE("Entries of RMF volumes are hashed from the volumes they are kept in", "[resources]")
+{
+  const auto folder = make_test_folder("rmf-duplicates");
+  write_rmf_volumes(folder);
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".rmf", std::make_unique<studio::resources::vol::three_space::rmf_file_archive>());
+
+  studio::resources::duplicate_finder finder;
+  finder.add_entries(explorer, explorer.find_files({ ".txt" }));
+  const auto result = finder.get_report();
+
+  REQUIRE(result.failures.empty());
+  REQUIRE(result.files_hashed == 3);
+  REQUIRE(result.bytes_hashed == 8);
+  REQUIRE(result.groups.size() == 1);
+  REQUIRE(result.groups[0].hash == hash_text("abc"));
+  REQUIRE(result.groups[0].entries.size() == 2);
+}
+
+TEST_CASE("A damaged compressed entry is reported without stopping the rest of its archive", "[resources]")
+{
+  using namespace std::literals;
+  const auto folder = make_test_folder("duplicates-damaged");
+
+  // The first entry uses the reserved block type, and the others are "abc" deflated with the fixed Huffman codes.
+  const auto abc = to_bytes("\x4b\x4c\x4a\x06\x00"sv);
+  const auto abc_crc = studio::resources::crc32(to_bytes("abc"));
+
+  write_file(folder / "damaged.zip", make_zip({
+    { "bad.txt", 8, to_bytes("\x07"), 5 },
+    { "first.txt", 8, abc, 3, abc_crc },
+    { "second.txt", 8, abc, 3, abc_crc },
+  }));
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".zip", std::make_unique<studio::resources::zip::zip_file_archive>());
+
+  studio::resources::duplicate_finder finder;
+  finder.add_entries(explorer, explorer.find_files({ ".txt" }));
+  const auto result = finder.get_report();
+
+  REQUIRE(result.failures.size() == 1);
+  REQUIRE(result.failures[0].path == folder / "damaged.zip" / "bad.txt");
+  REQUIRE(result.files_hashed == 2);
+  REQUIRE(result.groups.size() == 1);
+  REQUIRE(result.groups[0].hash == hash_text("abc"));
+}
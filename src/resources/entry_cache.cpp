@@ -0,0 +1,80 @@
+#include "resources/entry_cache.hpp"
+
+namespace studio::resources
+{
+  entry_cache::entry_cache(std::size_t budget_bytes) : budget(budget_bytes)
+  {
+  }
+
+  entry_cache::buffer entry_cache::get_or_add(const std::string& key, const std::function<std::vector<std::byte>()>& decode)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      if (auto existing = lookup.find(key); existing != lookup.end())
+      {
+        entries.splice(entries.begin(), entries, existing->second);
+        hits++;
+        return existing->second->data;
+      }
+    }
+
+    misses++;
+
+    auto result = std::make_shared<const std::vector<std::byte>>(decode());
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (auto existing = lookup.find(key); existing != lookup.end())
+    {
+      // Another thread decoded the same entry in the meantime.
+      return existing->second->data;
+    }
+
+    if (result->size() > budget)
+    {
+      return result;
+    }
+
+    evict(budget - result->size());
+
+    entries.push_front(entry{ key, result });
+    lookup.emplace(key, entries.begin());
+    used += result->size();
+
+    return result;
+  }
+
+  void entry_cache::set_budget(std::size_t budget_bytes)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget = budget_bytes;
+    evict(budget);
+  }
+
+  void entry_cache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    lookup.clear();
+    entries.clear();
+    used = 0;
+  }
+
+  entry_cache::statistics entry_cache::get_statistics() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics{ hits, misses, evictions, used, budget, entries.size() };
+  }
+
+  void entry_cache::evict(std::size_t new_budget)
+  {
+    while (used > new_budget && !entries.empty())
+    {
+      auto& oldest = entries.back();
+      used -= oldest.data->size();
+      lookup.erase(oldest.key);
+      entries.pop_back();
+      evictions++;
+    }
+  }
+}// namespace studio::resources
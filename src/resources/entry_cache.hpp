@@ -0,0 +1,69 @@
+#ifndef DARKSTARDTSCONVERTER_ENTRY_CACHE_HPP
+#define DARKSTARDTSCONVERTER_ENTRY_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace studio::resources
+{
+  // Keeps recently decoded archive entries in memory, up to a budget in bytes.
+  // Buffers are shared and immutable, so an entry can be evicted while views still hold on to it.
+  class entry_cache
+  {
+  public:
+    using buffer = std::shared_ptr<const std::vector<std::byte>>;
+
+    struct statistics
+    {
+      std::uint64_t hits;
+      std::uint64_t misses;
+      std::uint64_t evictions;
+      std::size_t used_bytes;
+      std::size_t budget_bytes;
+      std::size_t entry_count;
+    };
+
+    explicit entry_cache(std::size_t budget_bytes);
+
+    // Returns the cached buffer for the key, or decodes, stores and returns a new one.
+    // Decoding happens without holding the lock, so other entries stay available in the meantime.
+    buffer get_or_add(const std::string& key, const std::function<std::vector<std::byte>()>& decode);
+
+    void set_budget(std::size_t budget_bytes);
+
+    void clear();
+
+    statistics get_statistics() const;
+
+  private:
+    struct entry
+    {
+      std::string key;
+      buffer data;
+    };
+
+    void evict(std::size_t budget);
+
+    mutable std::mutex mutex;
+    std::size_t budget;
+    std::size_t used = 0;
+
+    // The most recently used entries are at the front.
+    std::list<entry> entries;
+    std::unordered_map<std::string, std::list<entry>::iterator> lookup;
+
+    std::atomic<std::uint64_t> hits = 0;
+    std::atomic<std::uint64_t> misses = 0;
+    std::atomic<std::uint64_t> evictions = 0;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_ENTRY_CACHE_HPP
@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+#include "entry_cache.hpp"
+
+namespace
+{
+  std::function<std::vector<std::byte>()> make_entry(std::size_t size, int& decode_count)
+  {
+    return [size, &decode_count] {
+      decode_count++;
+      return std::vector<std::byte>(size, std::byte{ 0x2a });
+    };
+  }
+}// namespace
+
+TEST_CASE("Decoded entries are evicted least recently used first", "[resources]")
+{
+  studio::resources::entry_cache cache(100);
+  int decode_count = 0;
+
+  cache.get_or_add("first", make_entry(40, decode_count));
+  cache.get_or_add("second", make_entry(40, decode_count));
+
+  // Using the first entry again makes the second one the oldest.
+  REQUIRE(cache.get_or_add("first", make_entry(40, decode_count))->size() == 40);
+
+  cache.get_or_add("third", make_entry(40, decode_count));
+  cache.get_or_add("first", make_entry(40, decode_count));
+
+  auto statistics = cache.get_statistics();
+  REQUIRE(decode_count == 3);
+  REQUIRE(statistics.hits == 2);
+  REQUIRE(statistics.misses == 3);
+  REQUIRE(statistics.evictions == 1);
+  REQUIRE(statistics.used_bytes == 80);
+
+  cache.get_or_add("second", make_entry(40, decode_count));
+  REQUIRE(decode_count == 4);
+
+  // Entries larger than the whole budget are handed out without being kept.
+  auto large = cache.get_or_add("large", make_entry(200, decode_count));
+  REQUIRE(large->size() == 200);
+  REQUIRE(cache.get_statistics().entry_count == 2);
+}
@@ -0,0 +1,55 @@
+#include <set>
+#include <system_error>
+#include "resources/file_handle_cache.hpp"
+
+namespace studio::resources
+{
+  namespace
+  {
+    std::mutex& get_registry_mutex()
+    {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    std::set<file_handle_cache_base*>& get_registry()
+    {
+      static std::set<file_handle_cache_base*> caches;
+      return caches;
+    }
+  }// namespace
+
+  void register_file_handle_cache(file_handle_cache_base* cache)
+  {
+    std::lock_guard<std::mutex> lock(get_registry_mutex());
+    get_registry().insert(cache);
+  }
+
+  void unregister_file_handle_cache(file_handle_cache_base* cache)
+  {
+    std::lock_guard<std::mutex> lock(get_registry_mutex());
+    get_registry().erase(cache);
+  }
+
+  void invalidate_file_handles(const std::filesystem::path& path)
+  {
+    // The registry stays locked, so that no cache can be destroyed while it is being invalidated.
+    std::lock_guard<std::mutex> lock(get_registry_mutex());
+
+    for (auto* cache : get_registry())
+    {
+      cache->invalidate(path);
+    }
+  }
+
+  bool is_same_file(const std::filesystem::path& first, const std::filesystem::path& second)
+  {
+    if (first.lexically_normal() == second.lexically_normal())
+    {
+      return true;
+    }
+
+    std::error_code error;
+    return std::filesystem::equivalent(first, second, error);
+  }
+}// namespace studio::resources
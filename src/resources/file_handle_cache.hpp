@@ -0,0 +1,121 @@
+#ifndef DARKSTARDTSCONVERTER_FILE_HANDLE_CACHE_HPP
+#define DARKSTARDTSCONVERTER_FILE_HANDLE_CACHE_HPP
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <filesystem>
+#include "file_stamp.hpp"
+
+namespace studio::resources
+{
+  class file_handle_cache_base
+  {
+  public:
+    virtual ~file_handle_cache_base() = default;
+
+    virtual void invalidate(const std::filesystem::path& path) = 0;
+  };
+
+  // Every live cache is registered, so that code which changes a file can drop its handles without knowing who opened it.
+  void register_file_handle_cache(file_handle_cache_base* cache);
+  void unregister_file_handle_cache(file_handle_cache_base* cache);
+
+  // Drops the cached handles of a file from every cache. Streams which are already open keep their handles.
+  void invalidate_file_handles(const std::filesystem::path& path);
+
+  bool is_same_file(const std::filesystem::path& first, const std::filesystem::path& second);
+
+  // Keeps one open instance of a file type per path, so that every stream for the same archive shares it.
+  // A file whose size or write time changed since it was opened is opened again,
+  // and only the most recently used files are kept open.
+  template<typename FileType>
+  class file_handle_cache : public file_handle_cache_base
+  {
+  public:
+    constexpr static std::size_t default_capacity = 64;
+
+    explicit file_handle_cache(std::size_t capacity = default_capacity) : capacity(std::max<std::size_t>(capacity, 1))
+    {
+      register_file_handle_cache(this);
+    }
+
+    ~file_handle_cache() override
+    {
+      unregister_file_handle_cache(this);
+    }
+
+    file_handle_cache(const file_handle_cache&) = delete;
+    file_handle_cache& operator=(const file_handle_cache&) = delete;
+
+    std::shared_ptr<const FileType> get(const std::filesystem::path& path)
+    {
+      const auto stamp = get_file_stamp(path);
+
+      std::lock_guard<std::mutex> lock(mutex);
+
+      auto existing = files.find(path);
+
+      if (existing != files.end())
+      {
+        if (stamp && existing->second.stamp == stamp)
+        {
+          recent.splice(recent.begin(), recent, existing->second.position);
+          return existing->second.file;
+        }
+
+        recent.erase(existing->second.position);
+        files.erase(existing);
+      }
+
+      auto result = std::make_shared<const FileType>(path);
+
+      recent.push_front(path);
+      files.emplace(path, cached_file{ stamp, result, recent.begin() });
+
+      while (files.size() > capacity)
+      {
+        files.erase(recent.back());
+        recent.pop_back();
+      }
+
+      return result;
+    }
+
+    void invalidate(const std::filesystem::path& path) override
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      for (auto existing = files.begin(); existing != files.end();)
+      {
+        if (is_same_file(existing->first, path))
+        {
+          recent.erase(existing->second.position);
+          existing = files.erase(existing);
+        }
+        else
+        {
+          ++existing;
+        }
+      }
+    }
+
+  private:
+    struct cached_file
+    {
+      std::optional<studio::resources::file_stamp> stamp;
+      std::shared_ptr<const FileType> file;
+      std::list<std::filesystem::path>::iterator position;
+    };
+
+    std::size_t capacity;
+    std::mutex mutex;
+    std::map<std::filesystem::path, cached_file> files;
+    std::list<std::filesystem::path> recent;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_FILE_HANDLE_CACHE_HPP
@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+#include <chrono>
+#include "shared_file.hpp"
+#include "darkstar_volume_writer.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+TEST_CASE("Cached file handles are reused until the file changes", "[resources]")
+{
+  const auto folder = make_test_folder("file-handle-cache");
+  const auto file_path = folder / "data.bin";
+  write_file(file_path, "first");
+
+  studio::resources::shared_file_cache cache;
+  const auto original = cache.get(file_path);
+
+  REQUIRE(cache.get(file_path) == original);
+
+  // The same size with a different write time is still a different file.
+  write_file(file_path, "other");
+  std::filesystem::last_write_time(file_path, std::filesystem::last_write_time(file_path) + std::chrono::seconds(10));
+
+  const auto changed = cache.get(file_path);
+  REQUIRE(changed != original);
+  REQUIRE(cache.get(file_path) == changed);
+}
+
+TEST_CASE("Only the most recently used file handles are kept", "[resources]")
+{
+  const auto folder = make_test_folder("file-handle-cache-lru");
+  write_file(folder / "a.bin", "a");
+  write_file(folder / "b.bin", "b");
+  write_file(folder / "c.bin", "c");
+
+  studio::resources::shared_file_cache cache(2);
+
+  const auto a = cache.get(folder / "a.bin");
+  const auto b = cache.get(folder / "b.bin");
+  REQUIRE(cache.get(folder / "a.bin") == a);
+
+  cache.get(folder / "c.bin");
+
+  REQUIRE(cache.get(folder / "a.bin") == a);
+  REQUIRE(cache.get(folder / "b.bin") != b);
+}
+
+TEST_CASE("Updating a volume drops its cached handles", "[resources]")
+{
+  const auto folder = make_test_folder("file-handle-cache-invalidate");
+  const auto volume_path = folder / "update.vol";
+
+  studio::resources::vol::darkstar::vol_writer writer;
+  writer.add_file("first.txt", to_bytes("first"));
+  writer.write(volume_path);
+
+  studio::resources::shared_file_cache cache;
+  const auto original = cache.get(folder / "." / "update.vol");
+
+  studio::resources::vol::darkstar::vol_updater updater(volume_path);
+  updater.add_file("second.txt", to_bytes("second"));
+  updater.commit();
+
+  const auto updated = cache.get(folder / "." / "update.vol");
+  REQUIRE(updated != original);
+  REQUIRE(updated->size() == std::filesystem::file_size(volume_path));
+
+  studio::resources::invalidate_file_handles(volume_path);
+  REQUIRE(cache.get(folder / "." / "update.vol") != updated);
+}
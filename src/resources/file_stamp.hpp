@@ -0,0 +1,48 @@
+#ifndef DARKSTARDTSCONVERTER_FILE_STAMP_HPP
+#define DARKSTARDTSCONVERTER_FILE_STAMP_HPP
+
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+
+namespace studio::resources
+{
+  // Identifies one version of a file on disk, so that anything derived from its contents can be reused until it changes.
+  struct file_stamp
+  {
+    std::uint64_t size;
+    std::int64_t write_time;
+
+    bool operator==(const file_stamp& other) const
+    {
+      return size == other.size && write_time == other.write_time;
+    }
+
+    bool operator!=(const file_stamp& other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  inline std::optional<file_stamp> get_file_stamp(const std::filesystem::path& file_path)
+  {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(file_path, error);
+
+    if (error)
+    {
+      return std::nullopt;
+    }
+
+    const auto write_time = std::filesystem::last_write_time(file_path, error);
+
+    if (error)
+    {
+      return std::nullopt;
+    }
+
+    return file_stamp{ size, std::int64_t(write_time.time_since_epoch().count()) };
+  }
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_FILE_STAMP_HPP
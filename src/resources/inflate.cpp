@@ -0,0 +1,470 @@
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include "resources/inflate.hpp"
+
+namespace studio::resources
+{
+  namespace
+  {
+    constexpr std::uint32_t fast_bits = 9;
+    constexpr std::uint32_t max_bits = 15;
+    constexpr std::size_t max_literal_codes = 288;
+    constexpr std::size_t max_distance_codes = 30;
+    constexpr std::uint32_t end_of_block = 256;
+    constexpr std::size_t max_distance = 32768;
+
+    constexpr std::array<std::uint16_t, 29> length_bases{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    constexpr std::array<std::uint8_t, 29> length_extra_bits{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    constexpr std::array<std::uint16_t, 30> distance_bases{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    constexpr std::array<std::uint8_t, 30> distance_extra_bits{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    // The order in which the lengths of the code length code are stored.
+    constexpr std::array<std::uint8_t, 19> code_length_order{ 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    // Bits are consumed starting from the least significant bit of each byte.
+    class bit_reader
+    {
+    public:
+      explicit bit_reader(bounded_reader& input) : input(input)
+      {
+      }
+
+      std::uint32_t peek(std::uint32_t count)
+      {
+        fill(count);
+        return std::uint32_t(buffer & ((std::uint64_t(1) << count) - 1));
+      }
+
+      void consume(std::uint32_t count)
+      {
+        buffer >>= count;
+        bit_count -= count;
+
+        // The zeroes added past the end of the data can be peeked at, but never used.
+        if (bit_count < overrun * 8)
+        {
+          throw std::invalid_argument("Deflate data ends before the last block.");
+        }
+      }
+
+      std::uint32_t get(std::uint32_t count)
+      {
+        const auto result = peek(count);
+        consume(count);
+        return result;
+      }
+
+      void align_to_byte()
+      {
+        consume(bit_count % 8);
+      }
+
+      std::byte get_byte()
+      {
+        return std::byte(get(8));
+      }
+
+    private:
+      // Peeking may look past the end of the data, since the last code can be shorter than what is peeked.
+      // Those bits read as zeroes, but consuming any of them stops decoding.
+      void fill(std::uint32_t count)
+      {
+        while (bit_count < count)
+        {
+          auto value = input.get();
+
+          if (value < 0)
+          {
+            if (++overrun > sizeof(buffer))
+            {
+              throw std::invalid_argument("Deflate data ends before the last block.");
+            }
+
+            value = 0;
+          }
+
+          buffer |= std::uint64_t(value) << bit_count;
+          bit_count += 8;
+        }
+      }
+
+      bounded_reader& input;
+      std::uint64_t buffer = 0;
+      std::uint32_t bit_count = 0;
+      std::size_t overrun = 0;
+    };
+
+    struct huffman_table
+    {
+      // Each entry holds a symbol in its upper bits and the length of its code in the lower 4, or zero when the code is longer.
+      // Entries are indexed by the next bits of input, which hold the codes in reverse.
+      std::array<std::uint16_t, 1 << fast_bits> fast;
+      std::array<std::uint16_t, max_bits + 1> counts;
+      std::array<std::uint16_t, max_literal_codes> symbols;
+
+      void build(const std::uint8_t* lengths, std::size_t count)
+      {
+        fast.fill(0);
+        counts.fill(0);
+
+        for (auto i = 0u; i < count; ++i)
+        {
+          counts[lengths[i]]++;
+        }
+
+        counts[0] = 0;
+
+        // Incomplete codes are allowed, such as a distance code with a single symbol, but codes which don't fit are not.
+        int left = 1;
+
+        for (auto length = 1u; length <= max_bits; ++length)
+        {
+          left = (left << 1) - counts[length];
+
+          if (left < 0)
+          {
+            throw std::invalid_argument("Deflate data has an invalid Huffman code.");
+          }
+        }
+
+        std::array<std::uint16_t, max_bits + 2> offsets{};
+
+        for (auto length = 1u; length <= max_bits; ++length)
+        {
+          offsets[length + 1] = offsets[length] + counts[length];
+        }
+
+        for (auto symbol = 0u; symbol < count; ++symbol)
+        {
+          if (lengths[symbol] != 0)
+          {
+            symbols[offsets[lengths[symbol]]++] = std::uint16_t(symbol);
+          }
+        }
+
+        // Canonical codes are handed out in order of length and then symbol, which is the order of the symbols array.
+        std::uint32_t code = 0;
+        std::size_t index = 0;
+
+        for (auto length = 1u; length <= fast_bits; ++length, code <<= 1)
+        {
+          for (auto i = 0u; i < counts[length]; ++i, ++code)
+          {
+            std::uint32_t reversed = 0;
+
+            for (auto bit = 0u; bit < length; ++bit)
+            {
+              reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+            }
+
+            const auto entry = std::uint16_t((symbols[index++] << 4) | length);
+
+            for (auto slot = reversed; slot < fast.size(); slot += 1u << length)
+            {
+              fast[slot] = entry;
+            }
+          }
+        }
+      }
+
+      std::uint32_t decode(bit_reader& bits) const
+      {
+        if (const auto entry = fast[bits.peek(fast_bits)]; entry != 0)
+        {
+          bits.consume(entry & 0xf);
+          return entry >> 4;
+        }
+
+        int code = 0;
+        int first = 0;
+        int index = 0;
+
+        for (auto length = 1u; length <= max_bits; ++length)
+        {
+          code |= int(bits.get(1));
+          const int count = counts[length];
+
+          if (code - first < count)
+          {
+            return symbols[index + code - first];
+          }
+
+          index += count;
+          first = (first + count) << 1;
+          code <<= 1;
+        }
+
+        throw std::invalid_argument("Deflate data has an invalid Huffman code.");
+      }
+    };
+
+    struct fixed_tables
+    {
+      huffman_table literals;
+      huffman_table distances;
+
+      fixed_tables()
+      {
+        std::array<std::uint8_t, max_literal_codes> literal_lengths{};
+
+        for (auto i = 0u; i < literal_lengths.size(); ++i)
+        {
+          literal_lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+        }
+
+        std::array<std::uint8_t, max_distance_codes> distance_lengths{};
+        distance_lengths.fill(5);
+
+        literals.build(literal_lengths.data(), literal_lengths.size());
+        distances.build(distance_lengths.data(), distance_lengths.size());
+      }
+    };
+
+    void read_dynamic_tables(bit_reader& bits, huffman_table& literals, huffman_table& distances)
+    {
+      const auto literal_count = bits.get(5) + 257;
+      const auto distance_count = bits.get(5) + 1;
+      const auto code_length_count = bits.get(4) + 4;
+
+      if (literal_count > 286 || distance_count > max_distance_codes)
+      {
+        throw std::invalid_argument("Deflate data has too many codes.");
+      }
+
+      std::array<std::uint8_t, code_length_order.size()> code_length_lengths{};
+
+      for (auto i = 0u; i < code_length_count; ++i)
+      {
+        code_length_lengths[code_length_order[i]] = std::uint8_t(bits.get(3));
+      }
+
+      huffman_table code_lengths;
+      code_lengths.build(code_length_lengths.data(), code_length_lengths.size());
+
+      std::array<std::uint8_t, max_literal_codes + max_distance_codes> lengths{};
+      const auto total = literal_count + distance_count;
+
+      for (auto index = 0u; index < total;)
+      {
+        const auto symbol = code_lengths.decode(bits);
+
+        if (symbol < 16)
+        {
+          lengths[index++] = std::uint8_t(symbol);
+          continue;
+        }
+
+        std::uint8_t value = 0;
+        std::uint32_t repeat = 0;
+
+        if (symbol == 16)
+        {
+          if (index == 0)
+          {
+            throw std::invalid_argument("Deflate data repeats a length which doesn't exist.");
+          }
+
+          value = lengths[index - 1];
+          repeat = 3 + bits.get(2);
+        }
+        else if (symbol == 17)
+        {
+          repeat = 3 + bits.get(3);
+        }
+        else
+        {
+          repeat = 11 + bits.get(7);
+        }
+
+        if (index + repeat > total)
+        {
+          throw std::invalid_argument("Deflate data has too many code lengths.");
+        }
+
+        for (; repeat > 0; --repeat)
+        {
+          lengths[index++] = value;
+        }
+      }
+
+      if (lengths[end_of_block] == 0)
+      {
+        throw std::invalid_argument("Deflate data has no end of block code.");
+      }
+
+      literals.build(lengths.data(), literal_count);
+      distances.build(lengths.data() + literal_count, distance_count);
+    }
+
+    // Matches refer back at most 32 KB, so only that much of the output is kept,
+    // and it is handed over each time the window fills up.
+    class window_output
+    {
+    public:
+      window_output(std::size_t output_size, const std::function<void(const std::byte*, std::size_t)>& flush) : output_size(output_size), flush(flush)
+      {
+      }
+
+      std::size_t size() const
+      {
+        return produced;
+      }
+
+      void put(std::byte value)
+      {
+        if (produced == output_size)
+        {
+          throw std::invalid_argument("Deflate data is larger than expected.");
+        }
+
+        window[produced++ & window_mask] = value;
+
+        if ((produced & window_mask) == 0)
+        {
+          flush(window.data(), window.size());
+        }
+      }
+
+      void copy(std::size_t distance, std::size_t length)
+      {
+        if (distance > produced)
+        {
+          throw std::invalid_argument("Deflate data refers to bytes before the start of the output.");
+        }
+
+        if (length > output_size - produced)
+        {
+          throw std::invalid_argument("Deflate data is larger than expected.");
+        }
+
+        // Matches can overlap with themselves, so they are copied one byte at a time.
+        for (auto i = 0u; i < length; ++i)
+        {
+          put(window[(produced - distance) & window_mask]);
+        }
+      }
+
+      void finish()
+      {
+        if (const auto remaining = produced & window_mask; remaining > 0)
+        {
+          flush(window.data(), remaining);
+        }
+      }
+
+    private:
+      constexpr static std::size_t window_mask = max_distance - 1;
+
+      std::size_t output_size;
+      const std::function<void(const std::byte*, std::size_t)>& flush;
+      std::size_t produced = 0;
+      std::array<std::byte, max_distance> window;
+    };
+
+    void decode_block(bit_reader& bits, const huffman_table& literals, const huffman_table& distances, window_output& output)
+    {
+      while (true)
+      {
+        const auto symbol = literals.decode(bits);
+
+        if (symbol < end_of_block)
+        {
+          output.put(std::byte(symbol));
+          continue;
+        }
+
+        if (symbol == end_of_block)
+        {
+          return;
+        }
+
+        const auto length_code = symbol - 257;
+
+        if (length_code >= length_bases.size())
+        {
+          throw std::invalid_argument("Deflate data has an invalid length.");
+        }
+
+        const std::size_t length = length_bases[length_code] + bits.get(length_extra_bits[length_code]);
+        const auto distance_code = distances.decode(bits);
+
+        if (distance_code >= distance_bases.size())
+        {
+          throw std::invalid_argument("Deflate data has an invalid distance.");
+        }
+
+        const std::size_t distance = distance_bases[distance_code] + bits.get(distance_extra_bits[distance_code]);
+
+        output.copy(distance, length);
+      }
+    }
+  }// namespace
+
+  std::size_t inflate(bounded_reader& input, std::size_t output_size, const std::function<void(const std::byte*, std::size_t)>& output)
+  {
+    const static fixed_tables fixed;
+
+    bit_reader bits(input);
+    huffman_table literals;
+    huffman_table distances;
+    window_output window(output_size, output);
+
+    auto last_block = false;
+
+    while (!last_block && window.size() < output_size)
+    {
+      last_block = bits.get(1) == 1;
+      const auto type = bits.get(2);
+
+      if (type == 0)
+      {
+        bits.align_to_byte();
+
+        const auto length = bits.get(16);
+        const auto inverted_length = bits.get(16);
+
+        if (length != (~inverted_length & 0xffff))
+        {
+          throw std::invalid_argument("Deflate data has a stored block with an invalid length.");
+        }
+
+        if (length > output_size - window.size())
+        {
+          throw std::invalid_argument("Deflate data is larger than expected.");
+        }
+
+        for (auto i = 0u; i < length; ++i)
+        {
+          window.put(bits.get_byte());
+        }
+      }
+      else if (type == 1)
+      {
+        decode_block(bits, fixed.literals, fixed.distances, window);
+      }
+      else if (type == 2)
+      {
+        read_dynamic_tables(bits, literals, distances);
+        decode_block(bits, literals, distances, window);
+      }
+      else
+      {
+        throw std::invalid_argument("Deflate data has an invalid block type.");
+      }
+    }
+
+    window.finish();
+
+    return window.size();
+  }
+
+  std::size_t inflate(bounded_reader& input, std::byte* output, std::size_t output_size)
+  {
+    return inflate(input, output_size, [output, written = std::size_t(0)](const std::byte* data, std::size_t size) mutable {
+      std::copy(data, data + size, output + written);
+      written += size;
+    });
+  }
+}// namespace studio::resources
@@ -0,0 +1,21 @@
+#ifndef DARKSTARDTSCONVERTER_INFLATE_HPP
+#define DARKSTARDTSCONVERTER_INFLATE_HPP
+
+#include <cstddef>
+#include <functional>
+#include "bounded_reader.hpp"
+
+namespace studio::resources
+{
+  // Decodes raw deflate data, as stored in zip files, into an output of a known size.
+  // Huffman codes of up to 9 bits are decoded with a single table lookup, which covers nearly every symbol in practice,
+  // while longer codes are decoded by walking the canonical code one bit at a time.
+  // Returns the number of bytes written, which is only less than "output_size" when the data ends early.
+  // Data which isn't valid deflate, or which decodes to more than "output_size", is rejected with std::invalid_argument.
+  std::size_t inflate(bounded_reader& input, std::byte* output, std::size_t output_size);
+
+  // The same, but the output is handed over in chunks of up to 32 KB as it is decoded, so that it never needs to be held in full.
+  std::size_t inflate(bounded_reader& input, std::size_t output_size, const std::function<void(const std::byte*, std::size_t)>& output);
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_INFLATE_HPP
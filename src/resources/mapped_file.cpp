@@ -0,0 +1,102 @@
+#include <system_error>
+#include "resources/mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace studio::resources
+{
+#ifdef _WIN32
+  mapped_file::mapped_file(const std::filesystem::path& path)
+  {
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      throw std::system_error(int(GetLastError()), std::system_category(), "Could not open " + path.string());
+    }
+
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(file, &file_size);
+    length = std::size_t(file_size.QuadPart);
+
+    // Empty files cannot be mapped, but an empty view is still valid.
+    if (length > 0)
+    {
+      auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+      if (mapping != nullptr)
+      {
+        start = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+      }
+
+      if (start == nullptr)
+      {
+        auto error = int(GetLastError());
+        CloseHandle(file);
+        throw std::system_error(error, std::system_category(), "Could not map " + path.string());
+      }
+    }
+
+    // The view keeps the file alive, so the handle is no longer needed.
+    CloseHandle(file);
+  }
+
+  mapped_file::~mapped_file()
+  {
+    if (start != nullptr)
+    {
+      UnmapViewOfFile(start);
+    }
+  }
+#else
+  mapped_file::mapped_file(const std::filesystem::path& path)
+  {
+    auto file = ::open(path.c_str(), O_RDONLY);
+
+    if (file == -1)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not open " + path.string());
+    }
+
+    struct stat file_stat{};
+    ::fstat(file, &file_stat);
+    length = std::size_t(file_stat.st_size);
+
+    // Empty files cannot be mapped, but an empty view is still valid.
+    if (length > 0)
+    {
+      auto* result = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+
+      if (result == MAP_FAILED)
+      {
+        auto error = errno;
+        ::close(file);
+        throw std::system_error(error, std::generic_category(), "Could not map " + path.string());
+      }
+
+      start = static_cast<const std::byte*>(result);
+    }
+
+    // The mapping keeps the file alive, so the descriptor is no longer needed.
+    ::close(file);
+  }
+
+  mapped_file::~mapped_file()
+  {
+    if (start != nullptr)
+    {
+      ::munmap(const_cast<std::byte*>(start), length);
+    }
+  }
+#endif
+}// namespace studio::resources
@@ -0,0 +1,41 @@
+#ifndef DARKSTARDTSCONVERTER_MAPPED_FILE_HPP
+#define DARKSTARDTSCONVERTER_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <nonstd/span.hpp>
+#include "file_handle_cache.hpp"
+
+namespace studio::resources
+{
+  // A read-only view of an entire file, backed by the virtual memory of the process.
+  class mapped_file
+  {
+  public:
+    explicit mapped_file(const std::filesystem::path& path);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file(mapped_file&&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file& operator=(mapped_file&&) = delete;
+
+    nonstd::span<const std::byte> data() const
+    {
+      return nonstd::span<const std::byte>(start, length);
+    }
+
+    std::size_t size() const
+    {
+      return length;
+    }
+
+  private:
+    const std::byte* start = nullptr;
+    std::size_t length = 0;
+  };
+
+  using mapped_file_cache = file_handle_cache<mapped_file>;
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_MAPPED_FILE_HPP
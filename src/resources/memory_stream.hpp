@@ -0,0 +1,123 @@
+#ifndef DARKSTARDTSCONVERTER_MEMORY_STREAM_HPP
+#define DARKSTARDTSCONVERTER_MEMORY_STREAM_HPP
+
+#include <memory>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstddef>
+#include <nonstd/span.hpp>
+
+namespace studio::resources
+{
+  // A seekable stream buffer which reads directly from existing memory, without copying it.
+  class memory_buffer : public std::basic_streambuf<std::byte>
+  {
+  public:
+    explicit memory_buffer(nonstd::span<const std::byte> data)
+    {
+      auto* begin = const_cast<std::byte*>(data.data());
+      setg(begin, begin, begin + data.size());
+    }
+
+  protected:
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override
+    {
+      if (!(which & std::ios_base::in))
+      {
+        return pos_type(off_type(-1));
+      }
+
+      off_type base = 0;
+
+      if (direction == std::ios_base::cur)
+      {
+        base = gptr() - eback();
+      }
+      else if (direction == std::ios_base::end)
+      {
+        base = egptr() - eback();
+      }
+
+      const auto target = base + offset;
+
+      if (target < 0 || target > egptr() - eback())
+      {
+        return pos_type(off_type(-1));
+      }
+
+      setg(eback(), eback() + target, egptr());
+      return pos_type(target);
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+    {
+      return seekoff(off_type(position), std::ios_base::beg, which);
+    }
+
+    std::streamsize showmanyc() override
+    {
+      return gptr() < egptr() ? egptr() - gptr() : -1;
+    }
+  };
+
+  // An input stream over memory owned by something else, such as a memory mapped file.
+  // The owner is kept alive for as long as the stream exists.
+  class memory_stream : public std::basic_istream<std::byte>
+  {
+  public:
+    explicit memory_stream(nonstd::span<const std::byte> data, std::shared_ptr<const void> owner = nullptr)
+      : std::basic_istream<std::byte>(nullptr), owner(std::move(owner)), buffer(data)
+    {
+      rdbuf(&buffer);
+    }
+
+  private:
+    std::shared_ptr<const void> owner;
+    memory_buffer buffer;
+  };
+
+  // An output stream buffer which appends everything written to it to a vector.
+  class vector_buffer : public std::basic_streambuf<std::byte>
+  {
+  public:
+    explicit vector_buffer(std::vector<std::byte>& data) : data(data)
+    {
+    }
+
+  protected:
+    int_type overflow(int_type value) override
+    {
+      if (!traits_type::eq_int_type(value, traits_type::eof()))
+      {
+        data.emplace_back(traits_type::to_char_type(value));
+      }
+
+      return traits_type::not_eof(value);
+    }
+
+    std::streamsize xsputn(const std::byte* values, std::streamsize count) override
+    {
+      data.insert(data.end(), values, values + count);
+      return count;
+    }
+
+  private:
+    std::vector<std::byte>& data;
+  };
+
+  class vector_stream : public std::basic_ostream<std::byte>
+  {
+  public:
+    explicit vector_stream(std::vector<std::byte>& data)
+      : std::basic_ostream<std::byte>(nullptr), buffer(data)
+    {
+      rdbuf(&buffer);
+    }
+
+  private:
+    vector_buffer buffer;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_MEMORY_STREAM_HPP
@@ -0,0 +1,29 @@
+#include "resources/resource_config.hpp"
+#include "resources/darkstar_volume.hpp"
+#include "resources/three_space_volume.hpp"
+#include "resources/trophy_bass_volume.hpp"
+#include "resources/zip_archive.hpp"
+#include "content/mis/mission.hpp"
+
+namespace studio::resources
+{
+  studio::resources::resource_explorer create_default_resource_explorer(const std::filesystem::path& search_path)
+  {
+    studio::resources::resource_explorer archive(search_path);
+
+    archive.add_archive_type(".mis", std::make_unique<mis::darkstar::mis_file_archive>(), mis::darkstar::mis_file_archive::supported_extensions);
+    archive.add_archive_type(".tbv", std::make_unique<vol::trophy_bass::tbv_file_archive>());
+    archive.add_archive_type(".rbx", std::make_unique<vol::trophy_bass::rbx_file_archive>());
+    archive.add_archive_type(".rmf", std::make_unique<vol::three_space::rmf_file_archive>());
+    archive.add_archive_type(".map", std::make_unique<vol::three_space::rmf_file_archive>());
+    archive.add_archive_type(".vga", std::make_unique<vol::three_space::rmf_file_archive>());
+    archive.add_archive_type(".dyn", std::make_unique<vol::three_space::dyn_file_archive>());
+    archive.add_archive_type(".vol", std::make_unique<vol::three_space::vol_file_archive>());
+    archive.add_archive_type(".vol", std::make_unique<vol::darkstar::vol_file_archive>());
+    archive.add_archive_type(".zip", std::make_unique<zip::zip_file_archive>());
+
+    archive.use_workspace_index(studio::resources::workspace_index::get_default_path(search_path));
+
+    return archive;
+  }
+}// namespace studio::resources
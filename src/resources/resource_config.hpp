@@ -0,0 +1,14 @@
+#ifndef DARKSTARDTSCONVERTER_RESOURCE_CONFIG_HPP
+#define DARKSTARDTSCONVERTER_RESOURCE_CONFIG_HPP
+
+#include <filesystem>
+#include "resource_explorer.hpp"
+
+namespace studio::resources
+{
+  // An explorer which knows about every archive format supported by the project.
+  // The explorer keeps a reference to the search path, so it has to outlive the explorer.
+  studio::resources::resource_explorer create_default_resource_explorer(const std::filesystem::path& search_path);
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_RESOURCE_CONFIG_HPP
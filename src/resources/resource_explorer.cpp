@@ -1,5 +1,8 @@
 #include <sstream>
+#include <unordered_set>
 #include "resource_explorer.hpp"
+#include "memory_stream.hpp"
+#include "task_pool.hpp"
 #include "shared.hpp"
 
 namespace studio::resources
@@ -8,7 +11,7 @@ namespace studio::resources
   {
     auto archive_path = folder_path;
 
-    while (!std::filesystem::exists(archive_path) && !std::filesystem::is_directory(archive_path))
+    while (!std::filesystem::exists(archive_path) && !std::filesystem::is_directory(archive_path) && archive_path.has_relative_path())
     {
       archive_path = archive_path.parent_path();
     }
@@ -16,6 +19,26 @@ namespace studio::resources
     return archive_path;
   }
 
+  std::map<std::filesystem::path, std::vector<studio::resources::file_info>> resource_explorer::group_by_archive(const std::vector<studio::resources::file_info>& entries)
+  {
+    std::unordered_map<std::string, std::filesystem::path> archive_paths;
+    std::map<std::filesystem::path, std::vector<studio::resources::file_info>> results;
+
+    for (const auto& entry : entries)
+    {
+      auto archive_path = archive_paths.find(entry.folder_path.u8string());
+
+      if (archive_path == archive_paths.end())
+      {
+        archive_path = archive_paths.emplace(entry.folder_path.u8string(), get_archive_path(entry.folder_path)).first;
+      }
+
+      results[archive_path->second].emplace_back(entry);
+    }
+
+    return results;
+  }
+
   void resource_explorer::add_action(std::string name, std::function<void(const studio::resources::file_info&)> action)
   {
     actions.emplace(std::move(name), std::move(action));
@@ -36,10 +59,113 @@ namespace studio::resources
     return search_path;
   }
 
+  void resource_explorer::use_memory_mapping(bool enabled)
+  {
+    if (enabled && !mapped_files)
+    {
+      mapped_files = std::make_unique<studio::resources::mapped_file_cache>();
+    }
+    else if (!enabled)
+    {
+      mapped_files.reset();
+    }
+  }
+
+  void resource_explorer::use_workspace_index(const std::filesystem::path& index_path)
+  {
+    index = std::make_unique<studio::resources::workspace_index>(index_path);
+    index->load();
+  }
+
+  void resource_explorer::save_workspace_index() const
+  {
+    if (index)
+    {
+      index->save();
+    }
+  }
+
+  void resource_explorer::set_entry_cache_budget(std::size_t budget_bytes)
+  {
+    decoded_entries->set_budget(budget_bytes);
+  }
+
+  studio::resources::entry_cache::statistics resource_explorer::get_entry_cache_statistics() const
+  {
+    return decoded_entries->get_statistics();
+  }
+
+  std::shared_ptr<const studio::resources::mapped_file> resource_explorer::map_file(const std::filesystem::path& file_path) const
+  {
+    if (mapped_files)
+    {
+      return mapped_files->get(file_path);
+    }
+
+    return std::make_shared<const studio::resources::mapped_file>(file_path);
+  }
+
+  std::unique_ptr<std::basic_istream<std::byte>> resource_explorer::open_file(const std::filesystem::path& file_path) const
+  {
+    if (mapped_files)
+    {
+      auto mapping = mapped_files->get(file_path);
+      return std::make_unique<studio::resources::memory_stream>(mapping->data(), mapping);
+    }
+
+    auto file = file_handles->get(file_path);
+    return std::make_unique<studio::resources::file_range_stream>(file, 0, file->size());
+  }
+
+  std::optional<std::uint64_t> resource_explorer::get_entry_offset(const studio::resources::archive_plugin& archive, const std::filesystem::path& archive_path, const studio::resources::file_info& info) const
+  {
+    // The plugin knows where the data of an entry starts, so let it position a stream and ask where it ended up.
+    auto stream = open_file(archive.get_data_path(archive_path, info));
+    archive.set_stream_position(*stream, info);
+
+    const auto offset = stream->tellg();
+
+    if (!*stream || offset < 0)
+    {
+      return std::nullopt;
+    }
+
+    return std::uint64_t(offset);
+  }
+
+  std::unique_ptr<std::basic_istream<std::byte>> resource_explorer::open_entry(const studio::resources::archive_plugin& archive, const std::filesystem::path& archive_path, const studio::resources::file_info& info) const
+  {
+    const auto offset = get_entry_offset(archive, archive_path, info);
+    const auto data_path = archive.get_data_path(archive_path, info);
+
+    if (mapped_files)
+    {
+      auto mapping = mapped_files->get(data_path);
+      const auto start = std::min<std::size_t>(offset.value_or(mapping->size()), mapping->size());
+      const auto size = std::min<std::size_t>(info.size, mapping->size() - start);
+
+      return std::make_unique<studio::resources::memory_stream>(mapping->data().subspan(start, size), mapping);
+    }
+
+    auto file = file_handles->get(data_path);
+    const auto start = std::min<std::uint64_t>(offset.value_or(file->size()), file->size());
+    const auto size = std::min<std::uint64_t>(info.size, file->size() - start);
+
+    return std::make_unique<studio::resources::file_range_stream>(file, start, size);
+  }
+
   void resource_explorer::add_archive_type(std::string extension, std::unique_ptr<studio::resources::archive_plugin> archive_type, std::optional<nonstd::span<std::string_view>> explicit_extensions)
   {
     auto result = archive_types.insert(std::make_pair(shared::to_lower(extension), std::move(archive_type)));
 
+    for (auto signature : result->second->stream_signatures())
+    {
+      archive_signatures.add(signature, result->second.get());
+    }
+
+    // Files which no plugin supported so far might be supported by the new one.
+    detected_types->entries.clear();
+
     if (explicit_extensions.has_value())
     {
       archive_explicit_extensions.emplace(std::make_pair(result->first, explicit_extensions.value()));
@@ -52,106 +178,141 @@ namespace studio::resources
     key << new_search_path;
     std::for_each(extensions.begin(), extensions.end(), [&](auto& ext) { key << ext; });
 
-    auto cache_result = info_cache.find(key.str());
+    return info_cache->get_or_add(key.str(), [&] {
+      auto results = crawl_files(new_search_path, extensions);
+      save_workspace_index();
+      return results;
+    });
+  }
 
-    if (cache_result != info_cache.end())
+  std::vector<studio::resources::file_info> resource_explorer::crawl_files(const std::filesystem::path& new_search_path, const std::vector<std::string_view>& extensions) const
+  {
+    // Each folder or archive is listed by its own task. The results of a listing are kept in a node of a tree
+    // which mirrors the listing order, so that flattening it afterwards gives the same order as a sequential crawl.
+    struct crawl_node
     {
-      return cache_result->second;
-    }
+      struct entry
+      {
+        std::optional<studio::resources::file_info> file;
+        std::unique_ptr<crawl_node> child;
+      };
 
-    std::vector<studio::resources::file_info> results;
+      std::vector<entry> entries;
+    };
 
-    auto files_folders = get_content_listing(new_search_path);
+    auto is_excluded = [&](const studio::resources::folder_info& folder) {
+      const auto ext = shared::to_lower(folder.full_path.extension().string());
 
-    std::function<void(decltype(files_folders)::const_reference)> get_files_folders = [&](const auto& file_folder) {
-      std::visit([&](const auto& folder) {
-        using T = std::decay_t<decltype(folder)>;
+      // There are specific archives that must not be queried, unless
+      // they or their supported formats are explicitly queried.
+      if (auto must_be_explicit = archive_explicit_extensions.find(ext);
+          must_be_explicit != archive_explicit_extensions.end() && std::filesystem::exists(folder.full_path) && !std::filesystem::is_directory(folder.full_path))
+      {
+        auto count = std::count(extensions.begin(), extensions.end(), "ALL");
 
-        if constexpr (std::is_same_v<T, studio::resources::folder_info>)
+        if (count == 0)
         {
-          const auto& real_folder = static_cast<const studio::resources::folder_info&>(folder);
-
-          const auto ext = shared::to_lower(real_folder.full_path.extension().string());
+          count = std::count(extensions.begin(), extensions.end(), ext);
+        }
 
-          // There are specific archives that must not be queried, unless
-          // they or their supported formats are explicitly queried.
-          if (auto must_be_explicit = archive_explicit_extensions.find(ext);
-              std::filesystem::exists(folder.full_path) &&
-              !std::filesystem::is_directory(real_folder.full_path) && must_be_explicit != archive_explicit_extensions.end())
+        if (count == 0)
+        {
+          for (auto value : must_be_explicit->second)
           {
-            auto count = std::count(extensions.begin(), extensions.end(), "ALL");
+            count += std::count(extensions.begin(), extensions.end(), value);
+          }
 
-            if (count == 0)
-            {
-              count = std::count(extensions.begin(), extensions.end(), ext);
-            }
+          return count == 0;
+        }
+      }
 
-            if (count == 0)
-            {
-              for (auto value : must_be_explicit->second)
-              {
-                count += std::count(extensions.begin(), extensions.end(), value);
-              }
-
-              if (count == 0)
-              {
-                return;
-              }
-            }
-          }
+      return false;
+    };
+
+    auto is_match = [&](const std::filesystem::path& filename) {
+      if (extensions.size() == 1 && extensions.front() == "ALL")
+      {
+        return true;
+      }
 
-          auto more_files = get_content_listing(folder.full_path);
+      const auto ext = shared::to_lower(filename.extension().string());
+      return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
+    };
+
+    studio::resources::task_group crawl(studio::resources::task_pool::shared());
+
+    std::function<void(const std::vector<studio::resources::archive_plugin::content_info>&, crawl_node&)> add_listing;
+
+    auto add_folder = [&](const studio::resources::folder_info& folder, crawl_node& node) {
+      if (std::filesystem::exists(folder.full_path) && !std::filesystem::is_directory(folder.full_path))
+      {
+        const auto ext = shared::to_lower(folder.full_path.filename().extension().string());
 
-          if (std::filesystem::exists(folder.full_path) && !std::filesystem::is_directory(folder.full_path))
+        if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end())
+        {
+          studio::resources::file_info info{};
+          info.filename = folder.full_path.filename();
+          info.folder_path = folder.full_path.parent_path();
+          node.entries.emplace_back().file = std::move(info);
+        }
+      }
+
+      add_listing(get_content_listing(folder.full_path), node);
+    };
+
+    add_listing = [&](const auto& listing, crawl_node& node) {
+      for (const auto& item : listing)
+      {
+        std::visit([&](const auto& info) {
+          using T = std::decay_t<decltype(info)>;
+
+          if constexpr (std::is_same_v<T, studio::resources::folder_info>)
           {
-            for (auto& extension : extensions)
+            if (is_excluded(info))
             {
-              if (shared::to_lower(folder.full_path.filename().extension().string()) == extension)
-              {
-                studio::resources::file_info info{};
-                info.filename = folder.full_path.filename();
-                info.folder_path = folder.full_path.parent_path();
-                results.emplace_back(info);
-                break;
-              }
+              return;
             }
-          }
 
-          for (auto& item : more_files)
-          {
-            get_files_folders(item);
-          }
-        }
+            auto& child = node.entries.emplace_back().child;
+            child = std::make_unique<crawl_node>();
 
-        if constexpr (std::is_same_v<T, studio::resources::file_info>)
-        {
-          if (extensions.size() == 1 && extensions.front() == "ALL")
-          {
-            results.emplace_back(folder);
+            crawl.run([&add_folder, folder = info, child = child.get()] { add_folder(folder, *child); });
           }
-          else
+
+          if constexpr (std::is_same_v<T, studio::resources::file_info>)
           {
-            for (auto& extension : extensions)
+            if (is_match(info.filename))
             {
-              auto ext = shared::to_lower(folder.filename.extension().string());
-              if (ext == extension)
-              {
-                results.emplace_back(folder);
-                break;
-              }
+              node.entries.emplace_back().file = info;
             }
           }
-        }
-      },
-        file_folder);
+        },
+          item);
+      }
     };
 
-    for (const auto& item : files_folders)
-    {
-      get_files_folders(item);
-    }
+    // The root is listed as a task too, so that any exception reaches the caller only once every task is done.
+    crawl_node root;
+    crawl.run([&] { add_listing(get_content_listing(new_search_path), root); });
+    crawl.wait();
+
+    std::vector<studio::resources::file_info> results;
+
+    std::function<void(crawl_node&)> flatten = [&](crawl_node& node) {
+      for (auto& entry : node.entries)
+      {
+        if (entry.file.has_value())
+        {
+          results.emplace_back(std::move(entry.file.value()));
+        }
+        else if (entry.child)
+        {
+          flatten(*entry.child);
+        }
+      }
+    };
 
-    info_cache.emplace(key.str(), results);
+    flatten(root);
 
     return results;
   }
@@ -166,13 +327,17 @@ namespace studio::resources
   {
     group1.reserve(group1.capacity() + group2.size());
 
-    for (auto& group2_item : group2)
+    std::unordered_set<std::string> existing_folders;
+    existing_folders.reserve(group1.size());
+
+    for (auto& group1_item : group1)
     {
-      auto result = std::find_if(group1.begin(), group1.end(), [&](const auto& group1_item) {
-        return group1_item.folder_path == group2_item.folder_path;
-      });
+      existing_folders.emplace(group1_item.folder_path.u8string());
+    }
 
-      if (result == group1.end())
+    for (auto& group2_item : group2)
+    {
+      if (existing_folders.emplace(group2_item.folder_path.u8string()).second)
       {
         group1.emplace_back(group2_item);
       }
@@ -195,41 +360,111 @@ namespace studio::resources
     {
       if (std::filesystem::is_directory(info.folder_path))
       {
-        return std::make_pair(info, std::make_unique<std::basic_ifstream<std::byte>>(info.folder_path / info.filename, std::ios::binary));
+        return std::make_pair(info, open_file(info.folder_path / info.filename));
       }
       else
       {
         auto archive_path = get_archive_path(info.folder_path);
-        auto file_stream = std::make_unique<std::basic_ifstream<std::byte>>(archive_path, std::ios::binary);
-
         auto archive = get_archive_type(archive_path);
 
         if (archive.has_value())
         {
-          archive->get().set_stream_position(*file_stream, info);
+          return std::make_pair(info, open_entry(archive->get(), archive_path, info));
         }
 
-        return std::make_pair(info, std::move(file_stream));
+        return std::make_pair(info, open_file(archive_path));
       }
     }
     else
     {
       auto archive_path = get_archive_path(info.folder_path);
-
-      auto file_stream = std::basic_ifstream<std::byte>(archive_path, std::ios::binary);
       auto archive = get_archive_type(archive_path);
 
-      auto memory_stream = std::make_unique<std::basic_stringstream<std::byte>>();
+      if (!archive.has_value())
+      {
+        return std::make_pair(info, std::make_unique<std::basic_stringstream<std::byte>>());
+      }
 
-      if (archive.has_value())
+      // Entries which are too large to be cached are decoded as they are read, when the archive allows it.
+      if (info.size > decoded_entries->get_statistics().budget_bytes)
       {
-        archive->get().extract_file_contents(file_stream, info, *memory_stream);
+        if (auto entry = archive->get().open_compressed_entry(open_file(archive_path), info); entry)
+        {
+          return std::make_pair(info, std::move(entry));
+        }
       }
 
-      return std::make_pair(info, std::move(memory_stream));
+      auto data = decode_entry(archive->get(), archive_path, info);
+
+      return std::make_pair(info, std::make_unique<studio::resources::memory_stream>(nonstd::span<const std::byte>(data->data(), data->size()), data));
     }
   }
 
+  studio::resources::entry_cache::buffer resource_explorer::decode_entry(const studio::resources::archive_plugin& archive, const std::filesystem::path& archive_path, const studio::resources::file_info& info) const
+  {
+    // Entries are identified by the version of the archive they come from, so a changed archive never returns stale data.
+    const auto stamp = get_file_stamp(archive_path).value_or(studio::resources::file_stamp{});
+
+    std::stringstream key;
+    key << archive_path.u8string() << '|' << stamp.size << '|' << stamp.write_time << '|' << info.offset << '|' << (info.folder_path / info.filename).u8string();
+
+    return decoded_entries->get_or_add(key.str(), [&] {
+      std::vector<std::byte> result;
+      result.reserve(info.size);
+
+      auto file_stream = open_file(archive_path);
+      studio::resources::vector_stream output(result);
+      archive.extract_file_contents(*file_stream, info, output);
+
+      return result;
+    });
+  }
+
+  std::optional<file_view> resource_explorer::load_file_view(const studio::resources::file_info& info) const
+  {
+    if (info.compression_type != studio::resources::compression_type::none)
+    {
+      // Compressed entries are decoded once into a buffer which is then shared by every view of them.
+      auto archive_path = get_archive_path(info.folder_path);
+      auto archive = get_archive_type(archive_path);
+
+      if (!archive.has_value())
+      {
+        return std::nullopt;
+      }
+
+      auto data = decode_entry(archive->get(), archive_path, info);
+      return file_view{ info, data, nonstd::span<const std::byte>(data->data(), data->size()) };
+    }
+
+    if (std::filesystem::is_directory(info.folder_path))
+    {
+      auto mapping = map_file(info.folder_path / info.filename);
+      return file_view{ info, mapping, mapping->data() };
+    }
+
+    auto archive_path = get_archive_path(info.folder_path);
+    auto archive = get_archive_type(archive_path);
+
+    if (!archive.has_value())
+    {
+      return std::nullopt;
+    }
+
+    const auto offset = get_entry_offset(archive->get(), archive_path, info);
+    auto mapping = map_file(archive->get().get_data_path(archive_path, info));
+
+    if (!offset.has_value() || offset.value() > mapping->size())
+    {
+      return std::nullopt;
+    }
+
+    const auto start = std::size_t(offset.value());
+    const auto size = std::min(info.size, mapping->size() - start);
+
+    return file_view{ info, mapping, mapping->data().subspan(start, size) };
+  }
+
   bool resource_explorer::is_regular_file(const std::filesystem::path& folder_path) const
   {
     auto archive_path = get_archive_path(folder_path);
@@ -243,34 +478,117 @@ namespace studio::resources
   }
 
   std::optional<std::reference_wrapper<studio::resources::archive_plugin>> resource_explorer::get_archive_type(const std::filesystem::path& file_path) const
+  {
+    auto ext = shared::to_lower(file_path.filename().extension().string());
+
+    if (archive_types.find(ext) == archive_types.end())
+    {
+      return std::nullopt;
+    }
+
+    const auto stamp = get_file_stamp(file_path);
+
+    if (!stamp.has_value())
+    {
+      return detect_archive_type(file_path);
+    }
+
+    const auto key = file_path.u8string();
+
+    {
+      std::shared_lock<std::shared_mutex> lock(detected_types->mutex);
+
+      if (auto existing = detected_types->entries.find(key);
+          existing != detected_types->entries.end() && existing->second.stamp == stamp.value())
+      {
+        if (existing->second.archive)
+        {
+          return std::ref(*existing->second.archive);
+        }
+
+        return std::nullopt;
+      }
+    }
+
+    auto result = detect_archive_type(file_path);
+
+    std::unique_lock<std::shared_mutex> lock(detected_types->mutex);
+    detected_types->entries.insert_or_assign(key, detection_cache::entry{ stamp.value(), result.has_value() ? &result->get() : nullptr });
+
+    return result;
+  }
+
+  std::optional<std::reference_wrapper<studio::resources::archive_plugin>> resource_explorer::detect_archive_type(const std::filesystem::path& file_path) const
   {
     auto ext = shared::to_lower(file_path.filename().extension().string());
     auto archive_type = archive_types.equal_range(ext);
 
+    if (archive_type.first == archive_type.second)
+    {
+      return std::nullopt;
+    }
+
+    // The start of the file is read once, and then only plugins with a matching signature check it further, in memory.
+    auto file_stream = open_file(file_path);
+
+    studio::resources::file_header header{};
+    const auto header_size = studio::resources::read_file_header(*file_stream, header);
+    const auto candidates = archive_signatures.find(nonstd::span<const std::byte>(header.data(), header_size));
+
     for (auto it = archive_type.first; it != archive_type.second; ++it)
     {
-      auto file_stream = std::basic_ifstream<std::byte>{ file_path, std::ios::binary };
+      auto* archive = it->second.get();
+
+      if (!archive_signatures.contains(archive))
+      {
+        // Without a signature, the plugin gets to look at the whole file.
+        file_stream->clear();
+        file_stream->seekg(0, std::ios::beg);
+
+        if (archive->stream_is_supported(*file_stream))
+        {
+          return std::ref(*archive);
+        }
+
+        continue;
+      }
+
+      if (std::find(candidates.begin(), candidates.end(), archive) == candidates.end())
+      {
+        continue;
+      }
+
+      studio::resources::memory_stream header_stream(nonstd::span<const std::byte>(header.data(), header_size));
 
-      if (it->second->stream_is_supported(file_stream))
+      if (archive->stream_is_supported(header_stream))
       {
-        return std::ref(*it->second);
+        return std::ref(*archive);
       }
     }
 
     return std::nullopt;
   }
 
-  void resource_explorer::extract_file_contents(std::basic_istream<std::byte>& archive_file, std::filesystem::path destination, const studio::resources::file_info& info) const
+  std::filesystem::path resource_explorer::get_extraction_folder(const std::filesystem::path& destination, const studio::resources::file_info& info) const
   {
     auto archive_path = get_archive_path(info.folder_path);
 
-    destination = destination / std::filesystem::relative(archive_path, search_path).parent_path() / archive_path.stem() / std::filesystem::relative(info.folder_path, archive_path).replace_extension("");
+    auto result = destination / std::filesystem::relative(archive_path, search_path).parent_path() / archive_path.stem() / std::filesystem::relative(info.folder_path, archive_path).replace_extension("");
 
-    if (archive_path.stem() == destination.stem())
+    if (archive_path.stem() == result.stem())
     {
-      destination = destination.parent_path();
+      result = result.parent_path();
     }
 
+    return result;
+  }
+
+  void resource_explorer::extract_file_contents(std::basic_istream<std::byte>& archive_file, std::filesystem::path destination, const studio::resources::file_info& info) const
+  {
+    auto archive_path = get_archive_path(info.folder_path);
+
+    destination = get_extraction_folder(destination, info);
+
     std::filesystem::create_directories(destination);
 
     std::basic_ofstream<std::byte> new_file(destination / info.filename, std::ios::binary);
@@ -287,11 +605,45 @@ namespace studio::resources
   {
     std::vector<std::variant<studio::resources::folder_info, studio::resources::file_info>> files;
 
-    if (auto archive_type = get_archive_type(get_archive_path(folder_path)); archive_type.has_value())
+    const auto archive_path = get_archive_path(folder_path);
+
+    if (index)
     {
-      auto file_stream = std::basic_ifstream<std::byte>{ get_archive_path(folder_path), std::ios::binary };
+      if (auto existing = index->find(folder_path, archive_path); existing.has_value())
+      {
+        return std::move(existing.value());
+      }
+    }
+
+    if (auto archive_type = get_archive_type(archive_path); archive_type.has_value())
+    {
+      auto file_stream = open_file(archive_path);
+
+      const auto& archive = archive_type.value().get();
+      auto listing = archive.get_content_listing(*file_stream, folder_path);
+
+      if (index)
+      {
+        // Entries kept outside of the archive, such as those of RMF volumes, make the listing depend on those files too.
+        std::vector<std::filesystem::path> data_paths;
+
+        for (const auto& item : listing)
+        {
+          if (const auto* file = std::get_if<studio::resources::file_info>(&item); file)
+          {
+            auto data_path = archive.get_data_path(archive_path, *file);
+
+            if (data_path != archive_path && std::find(data_paths.begin(), data_paths.end(), data_path) == data_paths.end())
+            {
+              data_paths.emplace_back(std::move(data_path));
+            }
+          }
+        }
+
+        index->store(folder_path, archive_path, listing, data_paths);
+      }
 
-      return archive_type.value().get().get_content_listing(file_stream, folder_path);
+      return listing;
     }
 
     for (auto& item : std::filesystem::directory_iterator(folder_path))
@@ -303,7 +655,7 @@ namespace studio::resources
         info.full_path = item.path();
         files.emplace_back(info);
       }
-      else if (auto archive_type = get_archive_type(item.path()); archive_type.has_value())
+      else if ((index && index->contains(item.path(), item.path())) || get_archive_type(item.path()).has_value())
       {
         studio::resources::folder_info info{};
         info.name = item.path().filename().string();
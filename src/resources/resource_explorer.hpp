@@ -9,13 +9,38 @@
 #include <fstream>
 #include <optional>
 #include <functional>
+#include <shared_mutex>
+#include <unordered_map>
 #include <nonstd/span.hpp>
 #include "archive_plugin.hpp"
+#include "mapped_file.hpp"
+#include "shared_file.hpp"
+#include "workspace_index.hpp"
+#include "concurrent_cache.hpp"
+#include "file_stamp.hpp"
+#include "signature_registry.hpp"
+#include "entry_cache.hpp"
+#include "memory_stream.hpp"
 
 namespace studio::resources
 {
   using file_stream = std::pair<studio::resources::file_info, std::unique_ptr<std::basic_istream<std::byte>>>;
 
+  // A read-only view of the bytes of a file, which stays valid for as long as the owner is kept alive.
+  // Views can be copied and shared between threads, and all of them refer to the same bytes.
+  struct file_view
+  {
+    studio::resources::file_info info;
+    std::shared_ptr<const void> owner;
+    nonstd::span<const std::byte> data;
+
+    // For code which expects a stream. The stream reads from the view and keeps it alive.
+    std::unique_ptr<std::basic_istream<std::byte>> open() const
+    {
+      return std::make_unique<studio::resources::memory_stream>(data, owner);
+    }
+  };
+
   struct null_buffer : public std::basic_streambuf<std::byte>
   {
     int overflow(int c) { return c; }
@@ -24,9 +49,16 @@ namespace studio::resources
   class resource_explorer
   {
   public:
-    explicit resource_explorer(const std::filesystem::path& search_path) : search_path(search_path) {}
+    explicit resource_explorer(const std::filesystem::path& search_path)
+      : search_path(search_path),
+        info_cache(std::make_unique<listing_cache>()),
+        detected_types(std::make_unique<detection_cache>()),
+        decoded_entries(std::make_unique<studio::resources::entry_cache>(default_entry_cache_budget)),
+        file_handles(std::make_unique<studio::resources::shared_file_cache>()) {}
 
     static std::filesystem::path get_archive_path(const std::filesystem::path& folder_path);
+    // Groups entries by the archive they come from, looking up each folder only once.
+    static std::map<std::filesystem::path, std::vector<studio::resources::file_info>> group_by_archive(const std::vector<studio::resources::file_info>& entries);
     static void merge_results(std::vector<studio::resources::file_info>& group1,
                               const std::vector<studio::resources::file_info>& group2);
 
@@ -36,6 +68,17 @@ namespace studio::resources
 
     std::filesystem::path get_search_path() const;
 
+    void use_memory_mapping(bool enabled);
+
+    void use_workspace_index(const std::filesystem::path& index_path);
+
+    // Limits how much memory is used to keep decompressed entries around. A budget of zero disables the cache.
+    void set_entry_cache_budget(std::size_t budget_bytes);
+
+    studio::resources::entry_cache::statistics get_entry_cache_statistics() const;
+
+    void save_workspace_index() const;
+
     void add_archive_type(std::string extension, std::unique_ptr<studio::resources::archive_plugin> archive_type, std::optional<nonstd::span<std::string_view>> explicit_extensions = std::nullopt);
 
     std::vector<studio::resources::file_info> find_files(const std::filesystem::path& new_search_path, const std::vector<std::string_view>& extensions) const;
@@ -44,15 +87,47 @@ namespace studio::resources
 
     file_stream load_file(const std::filesystem::path& path) const;
 
+    // Compressed entries are decoded once and shared through the entry cache. Entries larger than its whole budget
+    // are decoded as they are read instead, when their archive supports that.
     file_stream load_file(const studio::resources::file_info& info) const;
 
+    std::optional<file_view> load_file_view(const studio::resources::file_info& info) const;
+
     bool is_regular_file(const std::filesystem::path& folder_path) const;
 
     std::optional<std::reference_wrapper<studio::resources::archive_plugin>> get_archive_type(const std::filesystem::path& file_path) const;
     void extract_file_contents(std::basic_istream<std::byte>& archive_file, std::filesystem::path destination, const studio::resources::file_info& info) const;
+
+    // The folder an archive entry is extracted into, relative to the search path of the archive it comes from.
+    std::filesystem::path get_extraction_folder(const std::filesystem::path& destination, const studio::resources::file_info& info) const;
     std::vector<std::variant<studio::resources::folder_info, studio::resources::file_info>> get_content_listing(const std::filesystem::path& folder_path) const;
 
   private:
+    constexpr static std::size_t default_entry_cache_budget = 64 * 1024 * 1024;
+
+    using listing_cache = studio::resources::concurrent_cache<std::string, std::vector<studio::resources::file_info>>;
+
+    // Remembers which plugin supports a file, for as long as the file stays the same.
+    struct detection_cache
+    {
+      struct entry
+      {
+        studio::resources::file_stamp stamp;
+        studio::resources::archive_plugin* archive;
+      };
+
+      std::shared_mutex mutex;
+      std::unordered_map<std::string, entry> entries;
+    };
+
+    std::optional<std::reference_wrapper<studio::resources::archive_plugin>> detect_archive_type(const std::filesystem::path& file_path) const;
+    std::vector<studio::resources::file_info> crawl_files(const std::filesystem::path& new_search_path, const std::vector<std::string_view>& extensions) const;
+    std::unique_ptr<std::basic_istream<std::byte>> open_file(const std::filesystem::path& file_path) const;
+    std::shared_ptr<const studio::resources::mapped_file> map_file(const std::filesystem::path& file_path) const;
+    std::optional<std::uint64_t> get_entry_offset(const studio::resources::archive_plugin& archive, const std::filesystem::path& archive_path, const studio::resources::file_info& info) const;
+    studio::resources::entry_cache::buffer decode_entry(const studio::resources::archive_plugin& archive, const std::filesystem::path& archive_path, const studio::resources::file_info& info) const;
+    std::unique_ptr<std::basic_istream<std::byte>> open_entry(const studio::resources::archive_plugin& archive, const std::filesystem::path& archive_path, const studio::resources::file_info& info) const;
+
     const std::filesystem::path& search_path;
 
     std::locale default_locale;
@@ -60,9 +135,16 @@ namespace studio::resources
     std::map<std::string, nonstd::span<std::string_view>> archive_explicit_extensions;
 
     std::multimap<std::string, std::unique_ptr<studio::resources::archive_plugin>> archive_types;
+    studio::resources::signature_registry<studio::resources::archive_plugin*> archive_signatures;
     std::map<std::string, std::function<void(const studio::resources::file_info&)>> actions;
 
-    mutable std::map<std::string, std::vector<studio::resources::file_info>> info_cache;
+    std::unique_ptr<listing_cache> info_cache;
+    std::unique_ptr<detection_cache> detected_types;
+    std::unique_ptr<studio::resources::entry_cache> decoded_entries;
+
+    std::unique_ptr<studio::resources::shared_file_cache> file_handles;
+    std::unique_ptr<studio::resources::mapped_file_cache> mapped_files;
+    std::unique_ptr<studio::resources::workspace_index> index;
   };
 }// namespace studio::resource
 
@@ -0,0 +1,297 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "resource_explorer.hpp"
+#include "three_space_volume.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+TEST_CASE("Loose files can be viewed without copying", "[resources]")
+{
+  const auto folder = make_test_folder("loose-view");
+  write_file(folder / "readme.txt", "hello world");
+
+  studio::resources::resource_explorer explorer(folder);
+
+  studio::resources::file_info info{};
+  info.folder_path = folder;
+  info.filename = "readme.txt";
+  info.size = 11;
+
+  auto view = explorer.load_file_view(info);
+
+  REQUIRE(view.has_value());
+  REQUIRE(to_string(view->data) == "hello world");
+}
+
+TEST_CASE("Memory mapped archives are listed and viewed", "[resources]")
+{
+  using namespace std::literals;
+  const auto folder = make_test_folder("mapped-volume");
+
+  write_file(folder / "simple.vol", single_entry_volume);
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+  explorer.use_memory_mapping(true);
+
+  auto files = explorer.find_files({ ".txt" });
+
+  REQUIRE(files.size() == 1);
+  REQUIRE(files.front().filename == "plain.txt");
+
+  auto view = explorer.load_file_view(files.front());
+
+  REQUIRE(view.has_value());
+  REQUIRE(to_string(view->data) == "hello");
+
+  auto stream = explorer.load_file(files.front());
+  std::array<std::byte, 5> contents{};
+  stream.second->read(contents.data(), contents.size());
+
+  REQUIRE(to_string(contents) == "hello");
+}
+
+TEST_CASE("Archive entries cannot be read past their size", "[resources]")
+{
+  using namespace std::literals;
+  const auto folder = make_test_folder("bounded-entry");
+
+  write_file(folder / "pair.vol", two_entry_volume);
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+
+  auto files = explorer.find_files({ ".txt" });
+  REQUIRE(files.size() == 2);
+
+  auto first = explorer.load_file(files[0]);
+
+  std::array<std::byte, 8> contents{};
+  first.second->read(contents.data(), contents.size());
+
+  REQUIRE(first.second->gcount() == 2);
+  REQUIRE(to_string(nonstd::span<const std::byte>(contents.data(), 2)) == "ab");
+
+  std::vector<std::thread> threads;
+  std::atomic_int matches = 0;
+
+  for (auto i = 0; i < 8; ++i)
+  {
+    threads.emplace_back([&, i] {
+      const auto& info = files[i % 2];
+      auto entry = explorer.load_file(info);
+
+      std::array<std::byte, 3> bytes{};
+      entry.second->read(bytes.data(), std::streamsize(info.size));
+
+      if (to_string(nonstd::span<const std::byte>(bytes.data(), info.size)) == (i % 2 == 0 ? "ab" : "cde"))
+      {
+        matches++;
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  REQUIRE(matches == 8);
+}
+
+TEST_CASE("Archive listings are reused from the workspace index until the archive changes", "[resources]")
+{
+  using namespace std::literals;
+  const auto folder = make_test_folder("workspace-index");
+  const auto index_path = folder / "workspace.index";
+
+  write_file(folder / "simple.vol", single_entry_volume);
+
+  {
+    studio::resources::resource_explorer explorer(folder);
+    explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+    explorer.use_workspace_index(index_path);
+
+    REQUIRE(explorer.find_files({ ".txt" }).size() == 1);
+  }
+
+  REQUIRE(std::filesystem::exists(index_path));
+
+  studio::resources::workspace_index index(index_path);
+  index.load();
+
+  REQUIRE(index.contains(folder / "simple.vol", folder / "simple.vol"));
+
+  // Without any plugins the volume can only be listed through the index.
+  studio::resources::resource_explorer explorer(folder);
+  explorer.use_workspace_index(index_path);
+
+  auto files = explorer.find_files({ ".txt" });
+  REQUIRE(files.size() == 1);
+  REQUIRE(files.front().filename == "plain.txt");
+
+  write_file(folder / "simple.vol", "VOLN"sv);
+
+  REQUIRE_FALSE(index.contains(folder / "simple.vol", folder / "simple.vol"));
+}
+
+TEST_CASE("Listings of RMF volumes are reused from the workspace index until the volume changes", "[resources]")
+{
+  const auto folder = make_test_folder("workspace-index-rmf");
+  const auto index_path = folder / "workspace.index";
+  write_rmf_volumes(folder);
+
+  {
+    studio::resources::resource_explorer explorer(folder);
+    explorer.add_archive_type(".rmf", std::make_unique<studio::resources::vol::three_space::rmf_file_archive>());
+    explorer.use_workspace_index(index_path);
+
+    REQUIRE(explorer.find_files({ ".txt" }).size() == 3);
+    explorer.save_workspace_index();
+  }
+
+  studio::resources::workspace_index index(index_path);
+  index.load();
+
+  REQUIRE(index.contains(folder / "test.rmf" / "first.vol", folder / "test.rmf"));
+  REQUIRE(index.contains(folder / "test.rmf" / "second.vol", folder / "test.rmf"));
+
+  // The RMF file stays the same, but the entries of one of its volumes no longer do.
+  write_file(folder / "first.vol", "changed");
+
+  REQUIRE_FALSE(index.contains(folder / "test.rmf" / "first.vol", folder / "test.rmf"));
+  REQUIRE(index.contains(folder / "test.rmf" / "second.vol", folder / "test.rmf"));
+}
+
+TEST_CASE("The workspace index can be saved from several threads at once", "[resources]")
+{
+  const auto folder = make_test_folder("workspace-index-saves");
+  const auto index_path = folder / "workspace.index";
+
+  studio::resources::workspace_index index(index_path);
+  std::vector<std::thread> threads;
+
+  for (auto i = 0; i < 8; ++i)
+  {
+    const auto archive_path = folder / ("archive" + std::to_string(i) + ".vol");
+    write_file(archive_path, "VOLN");
+
+    threads.emplace_back([&index, archive_path] {
+      studio::resources::file_info info{};
+      info.filename = "plain.txt";
+      info.folder_path = archive_path;
+
+      index.store(archive_path, archive_path, { info });
+      index.save();
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  // Every save uses a temporary file of its own, and none of them are left behind.
+  REQUIRE(std::distance(std::filesystem::directory_iterator(folder), std::filesystem::directory_iterator()) == 9);
+
+  studio::resources::workspace_index loaded(index_path);
+  loaded.load();
+
+  for (auto i = 0; i < 8; ++i)
+  {
+    const auto archive_path = folder / ("archive" + std::to_string(i) + ".vol");
+    REQUIRE(loaded.contains(archive_path, archive_path));
+  }
+}
+
+TEST_CASE("Nested folders are crawled in parallel with a stable order", "[resources]")
+{
+  const auto folder = make_test_folder("parallel-crawl");
+
+  for (auto i = 0; i < 8; ++i)
+  {
+    auto child = folder / ("folder" + std::to_string(i));
+
+    for (auto j = 0; j < 4; ++j)
+    {
+      std::filesystem::create_directories(child / std::to_string(j));
+      write_file(child / std::to_string(j) / "item.txt", "item");
+    }
+  }
+
+  auto to_names = [&](const std::vector<studio::resources::file_info>& files) {
+    std::vector<std::string> names;
+
+    for (auto& file : files)
+    {
+      names.emplace_back((file.folder_path / file.filename).lexically_relative(folder).generic_string());
+    }
+
+    return names;
+  };
+
+  studio::resources::resource_explorer first(folder);
+  studio::resources::resource_explorer second(folder);
+
+  const auto first_names = to_names(first.find_files({ ".txt" }));
+
+  REQUIRE(first_names.size() == 32);
+  REQUIRE(first_names == to_names(second.find_files({ ".txt" })));
+}
+
+TEST_CASE("Archive detection is remembered until the file changes", "[resources]")
+{
+  using namespace std::literals;
+  const auto folder = make_test_folder("archive-detection");
+  const auto volume = folder / "later.vol";
+
+  write_file(volume, "junk"sv);
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+
+  REQUIRE_FALSE(explorer.get_archive_type(volume).has_value());
+  REQUIRE_FALSE(explorer.get_archive_type(volume).has_value());
+
+  write_file(volume, "VOLN\0\0\0\0\0\0\0\0"
+                     "\0\0\0\0\0\0"sv);
+
+  REQUIRE(explorer.get_archive_type(volume).has_value());
+}
+
+TEST_CASE("Compressed entries are decoded once and shared between views", "[resources]")
+{
+  using namespace std::literals;
+  const auto folder = make_test_folder("shared-entry");
+
+  write_file(folder / "packed.vol", "VOLN\0\0\0\0\0\0\0\0"
+                                    "\x01\0\0\0\0\0"
+                                    "packed.txt\0\0\0\0"
+                                    "\x24\0\0\0"
+                                    "\x09\x09\0\0\0\x0f\0\0\0"
+                                    "\x77" "abc" "\x02\x06" "XYZ"sv);
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+
+  auto files = explorer.find_files({ ".txt" });
+  REQUIRE(files.size() == 1);
+
+  auto first = explorer.load_file_view(files.front());
+  auto second = explorer.load_file_view(files.front());
+
+  REQUIRE(first.has_value());
+  REQUIRE(second.has_value());
+  REQUIRE(first->data.data() == second->data.data());
+  REQUIRE(to_string(first->data) == "abcabcabcabcXYZ");
+
+  auto stream = second->open();
+  std::array<std::byte, 3> contents{};
+  stream->read(contents.data(), contents.size());
+  REQUIRE(to_string(contents) == "abc");
+
+  REQUIRE(explorer.get_entry_cache_statistics().hits == 1);
+}
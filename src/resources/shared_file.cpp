@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include "resources/shared_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+namespace studio::resources
+{
+  constexpr std::size_t max_buffer_size = 65536;
+
+#ifdef _WIN32
+  shared_file::shared_file(const std::filesystem::path& path)
+  {
+    handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+      throw std::system_error(int(GetLastError()), std::system_category(), "Could not open " + path.string());
+    }
+
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(handle, &file_size);
+    length = std::uint64_t(file_size.QuadPart);
+  }
+
+  shared_file::~shared_file()
+  {
+    CloseHandle(handle);
+  }
+
+  std::size_t shared_file::read_at(std::uint64_t offset, std::byte* output, std::size_t count) const
+  {
+    std::size_t total = 0;
+
+    while (total < count)
+    {
+      // An explicit offset makes the read independent of the file pointer of the handle.
+      OVERLAPPED position{};
+      position.Offset = DWORD((offset + total) & 0xffffffff);
+      position.OffsetHigh = DWORD((offset + total) >> 32);
+
+      DWORD bytes_read = 0;
+      const auto to_read = DWORD(std::min<std::size_t>(count - total, 0x40000000));
+
+      if (!ReadFile(handle, output + total, to_read, &bytes_read, &position) || bytes_read == 0)
+      {
+        break;
+      }
+
+      total += bytes_read;
+    }
+
+    return total;
+  }
+#else
+  shared_file::shared_file(const std::filesystem::path& path)
+  {
+    descriptor = ::open(path.c_str(), O_RDONLY);
+
+    if (descriptor == -1)
+    {
+      throw std::system_error(errno, std::generic_category(), "Could not open " + path.string());
+    }
+
+    struct stat file_stat{};
+    ::fstat(descriptor, &file_stat);
+    length = std::uint64_t(file_stat.st_size);
+  }
+
+  shared_file::~shared_file()
+  {
+    ::close(descriptor);
+  }
+
+  std::size_t shared_file::read_at(std::uint64_t offset, std::byte* output, std::size_t count) const
+  {
+    std::size_t total = 0;
+
+    while (total < count)
+    {
+      const auto result = ::pread(descriptor, output + total, count - total, off_t(offset + total));
+
+      if (result == -1 && errno == EINTR)
+      {
+        continue;
+      }
+
+      if (result <= 0)
+      {
+        break;
+      }
+
+      total += std::size_t(result);
+    }
+
+    return total;
+  }
+#endif
+
+  file_range_buffer::file_range_buffer(std::shared_ptr<const shared_file> file, std::uint64_t offset, std::uint64_t size)
+    : file(std::move(file)), start(offset), length(size)
+  {
+    buffer.resize(std::size_t(std::clamp<std::uint64_t>(size, 1, max_buffer_size)));
+    setg(buffer.data(), buffer.data(), buffer.data());
+  }
+
+  std::uint64_t file_range_buffer::current_position() const
+  {
+    return buffer_position + std::uint64_t(gptr() - eback());
+  }
+
+  file_range_buffer::int_type file_range_buffer::underflow()
+  {
+    if (gptr() < egptr())
+    {
+      return traits_type::to_int_type(*gptr());
+    }
+
+    const auto position = current_position();
+
+    if (position >= length)
+    {
+      return traits_type::eof();
+    }
+
+    const auto count = std::size_t(std::min<std::uint64_t>(buffer.size(), length - position));
+    const auto bytes_read = file->read_at(start + position, buffer.data(), count);
+
+    buffer_position = position;
+    setg(buffer.data(), buffer.data(), buffer.data() + bytes_read);
+
+    if (bytes_read == 0)
+    {
+      return traits_type::eof();
+    }
+
+    return traits_type::to_int_type(*gptr());
+  }
+
+  std::streamsize file_range_buffer::xsgetn(std::byte* output, std::streamsize count)
+  {
+    std::streamsize copied = 0;
+
+    while (copied < count)
+    {
+      if (gptr() == egptr())
+      {
+        const auto position = current_position();
+        const auto remaining = std::uint64_t(count - copied);
+
+        // Large reads go straight into the output instead of through the buffer.
+        if (remaining >= buffer.size())
+        {
+          const auto to_read = std::size_t(std::min(remaining, length - std::min(position, length)));
+          const auto bytes_read = file->read_at(start + position, output + copied, to_read);
+
+          buffer_position = position + bytes_read;
+          setg(buffer.data(), buffer.data(), buffer.data());
+          copied += std::streamsize(bytes_read);
+          break;
+        }
+
+        if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+        {
+          break;
+        }
+      }
+
+      const auto available = std::min(std::streamsize(egptr() - gptr()), count - copied);
+      std::memcpy(output + copied, gptr(), std::size_t(available));
+      gbump(int(available));
+      copied += available;
+    }
+
+    return copied;
+  }
+
+  std::streamsize file_range_buffer::showmanyc()
+  {
+    const auto position = current_position();
+    return position < length ? std::streamsize(length - position) : -1;
+  }
+
+  file_range_buffer::pos_type file_range_buffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which)
+  {
+    if (!(which & std::ios_base::in))
+    {
+      return pos_type(off_type(-1));
+    }
+
+    off_type base = 0;
+
+    if (direction == std::ios_base::cur)
+    {
+      base = off_type(current_position());
+    }
+    else if (direction == std::ios_base::end)
+    {
+      base = off_type(length);
+    }
+
+    const auto target = base + offset;
+
+    if (target < 0 || std::uint64_t(target) > length)
+    {
+      return pos_type(off_type(-1));
+    }
+
+    // Seeking within what is already buffered keeps the buffer, otherwise it is dropped.
+    const auto buffered = std::uint64_t(egptr() - eback());
+
+    if (std::uint64_t(target) >= buffer_position && std::uint64_t(target) <= buffer_position + buffered)
+    {
+      setg(eback(), eback() + (std::uint64_t(target) - buffer_position), egptr());
+    }
+    else
+    {
+      buffer_position = std::uint64_t(target);
+      setg(buffer.data(), buffer.data(), buffer.data());
+    }
+
+    return pos_type(target);
+  }
+
+  file_range_buffer::pos_type file_range_buffer::seekpos(pos_type position, std::ios_base::openmode which)
+  {
+    return seekoff(off_type(position), std::ios_base::beg, which);
+  }
+}// namespace studio::resources
@@ -0,0 +1,82 @@
+#ifndef DARKSTARDTSCONVERTER_SHARED_FILE_HPP
+#define DARKSTARDTSCONVERTER_SHARED_FILE_HPP
+
+#include <vector>
+#include <memory>
+#include <istream>
+#include <cstdint>
+#include <filesystem>
+#include "file_handle_cache.hpp"
+
+namespace studio::resources
+{
+  // A read-only file handle which only ever reads at explicit offsets.
+  // Because there is no shared file position, any number of threads can read from it at once.
+  class shared_file
+  {
+  public:
+    explicit shared_file(const std::filesystem::path& path);
+    ~shared_file();
+
+    shared_file(const shared_file&) = delete;
+    shared_file(shared_file&&) = delete;
+    shared_file& operator=(const shared_file&) = delete;
+    shared_file& operator=(shared_file&&) = delete;
+
+    std::size_t read_at(std::uint64_t offset, std::byte* output, std::size_t count) const;
+
+    std::uint64_t size() const
+    {
+      return length;
+    }
+
+  private:
+#ifdef _WIN32
+    void* handle = nullptr;
+#else
+    int descriptor = -1;
+#endif
+    std::uint64_t length = 0;
+  };
+
+  using shared_file_cache = file_handle_cache<shared_file>;
+
+  // A stream buffer over a range of a shared file, such as a single archive entry.
+  // Positions are relative to the start of the range, and nothing past the end of the range can be read.
+  class file_range_buffer : public std::basic_streambuf<std::byte>
+  {
+  public:
+    file_range_buffer(std::shared_ptr<const shared_file> file, std::uint64_t offset, std::uint64_t size);
+
+  protected:
+    int_type underflow() override;
+    std::streamsize xsgetn(std::byte* output, std::streamsize count) override;
+    std::streamsize showmanyc() override;
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+
+  private:
+    std::uint64_t current_position() const;
+
+    std::shared_ptr<const shared_file> file;
+    std::uint64_t start;
+    std::uint64_t length;
+    std::uint64_t buffer_position = 0;
+    std::vector<std::byte> buffer;
+  };
+
+  class file_range_stream : public std::basic_istream<std::byte>
+  {
+  public:
+    file_range_stream(std::shared_ptr<const shared_file> file, std::uint64_t offset, std::uint64_t size)
+      : std::basic_istream<std::byte>(nullptr), buffer(std::move(file), offset, size)
+    {
+      rdbuf(&buffer);
+    }
+
+  private:
+    file_range_buffer buffer;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_SHARED_FILE_HPP
@@ -0,0 +1,124 @@
+#ifndef DARKSTARDTSCONVERTER_SIGNATURE_REGISTRY_HPP
+#define DARKSTARDTSCONVERTER_SIGNATURE_REGISTRY_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <istream>
+#include <algorithm>
+#include <string_view>
+#include <nonstd/span.hpp>
+
+namespace studio::resources
+{
+  using file_signature = nonstd::span<const std::byte>;
+
+  // Enough of the start of a file for every format to be recognised without reading it again.
+  constexpr std::size_t file_header_size = 256;
+
+  using file_header = std::array<std::byte, file_header_size>;
+
+  // Reads the start of a stream and moves back to where it was, returning how many bytes were available.
+  inline std::size_t read_file_header(std::basic_istream<std::byte>& stream, file_header& header)
+  {
+    const auto start = stream.tellg();
+
+    stream.read(header.data(), std::streamsize(header.size()));
+    const auto count = std::size_t(stream.gcount());
+
+    stream.clear();
+    stream.seekg(start, std::ios::beg);
+
+    return count;
+  }
+
+  inline file_signature to_signature(std::string_view value)
+  {
+    return file_signature(reinterpret_cast<const std::byte*>(value.data()), value.size());
+  }
+
+  // Maps the magic bytes at the start of a file to the handlers which registered them, using a prefix tree.
+  // Looking up a header walks the tree once, no matter how many formats are registered.
+  template<typename HandlerType>
+  class signature_registry
+  {
+  public:
+    signature_registry() : nodes(1)
+    {
+    }
+
+    void add(file_signature signature, HandlerType handler)
+    {
+      std::size_t current = 0;
+
+      for (auto value : signature)
+      {
+        auto& children = nodes[current].children;
+        auto child = std::find_if(children.begin(), children.end(), [&](const auto& item) { return item.first == value; });
+
+        if (child == children.end())
+        {
+          children.emplace_back(value, nodes.size());
+          current = nodes.size();
+          nodes.emplace_back();
+        }
+        else
+        {
+          current = child->second;
+        }
+      }
+
+      if (!contains(handler))
+      {
+        registered.emplace_back(handler);
+      }
+
+      auto& handlers = nodes[current].handlers;
+
+      if (std::find(handlers.begin(), handlers.end(), handler) == handlers.end())
+      {
+        handlers.emplace_back(handler);
+      }
+    }
+
+    // Returns every handler with a signature that the header starts with, longest signatures first.
+    std::vector<HandlerType> find(nonstd::span<const std::byte> header) const
+    {
+      std::vector<HandlerType> results;
+      std::size_t current = 0;
+
+      for (auto value : header)
+      {
+        const auto& children = nodes[current].children;
+        auto child = std::find_if(children.begin(), children.end(), [&](const auto& item) { return item.first == value; });
+
+        if (child == children.end())
+        {
+          break;
+        }
+
+        current = child->second;
+        results.insert(results.begin(), nodes[current].handlers.begin(), nodes[current].handlers.end());
+      }
+
+      return results;
+    }
+
+    bool contains(HandlerType handler) const
+    {
+      return std::find(registered.begin(), registered.end(), handler) != registered.end();
+    }
+
+  private:
+    struct node
+    {
+      std::vector<std::pair<std::byte, std::size_t>> children;
+      std::vector<HandlerType> handlers;
+    };
+
+    std::vector<node> nodes;
+    std::vector<HandlerType> registered;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_SIGNATURE_REGISTRY_HPP
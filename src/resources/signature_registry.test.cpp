@@ -0,0 +1,21 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include "signature_registry.hpp"
+
+TEST_CASE("Signatures are matched by prefix with the longest first", "[resources]")
+{
+  using studio::resources::to_signature;
+
+  studio::resources::signature_registry<std::string> registry;
+  registry.add(to_signature("BM"), "windows bitmap");
+  registry.add(to_signature("PBMP"), "phoenix bitmap");
+  registry.add(to_signature("PBMA"), "phoenix bitmap array");
+  registry.add(to_signature("P"), "anything starting with P");
+
+  REQUIRE(registry.find(to_signature("PBMA\x10\0\0\0")) == std::vector<std::string>{ "phoenix bitmap array", "anything starting with P" });
+  REQUIRE(registry.find(to_signature("BM")) == std::vector<std::string>{ "windows bitmap" });
+  REQUIRE(registry.find(to_signature("B")).empty());
+  REQUIRE(registry.find(to_signature("VOLN")).empty());
+  REQUIRE(registry.contains("phoenix bitmap"));
+  REQUIRE_FALSE(registry.contains("mission"));
+}
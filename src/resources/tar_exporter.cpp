@@ -0,0 +1,324 @@
+#include <map>
+#include <array>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include "resources/tar_exporter.hpp"
+#include "resources/memory_stream.hpp"
+
+namespace studio::resources
+{
+  namespace
+  {
+    constexpr std::size_t block_size = 512;
+
+    struct ustar_header
+    {
+      char name[100];
+      char mode[8];
+      char user_id[8];
+      char group_id[8];
+      char size[12];
+      char modified_time[12];
+      char checksum[8];
+      char type;
+      char link_name[100];
+      char magic[6];
+      char version[2];
+      char user_name[32];
+      char group_name[32];
+      char device_major[8];
+      char device_minor[8];
+      char prefix[155];
+      char padding[12];
+    };
+
+    static_assert(sizeof(ustar_header) == block_size);
+
+    using output_function = std::function<void(const std::byte*, std::size_t)>;
+
+    template<std::size_t Size>
+    void put_octal(char (&field)[Size], std::uint64_t value)
+    {
+      for (auto i = Size - 1; i > 0; --i)
+      {
+        field[i - 1] = char('0' + (value & 7));
+        value >>= 3;
+      }
+
+      field[Size - 1] = '\0';
+    }
+
+    template<std::size_t Size>
+    void put_string(char (&field)[Size], std::string_view value)
+    {
+      std::memcpy(field, value.data(), std::min(value.size(), Size));
+    }
+
+    // Long paths are split over the prefix and name fields at a slash, when there is one in the right place.
+    bool put_path(ustar_header& header, std::string_view path)
+    {
+      if (path.size() <= sizeof(header.name))
+      {
+        put_string(header.name, path);
+        return true;
+      }
+
+      for (auto split = path.find('/'); split != std::string_view::npos; split = path.find('/', split + 1))
+      {
+        if (split <= sizeof(header.prefix) && path.size() - split - 1 <= sizeof(header.name))
+        {
+          put_string(header.prefix, path.substr(0, split));
+          put_string(header.name, path.substr(split + 1));
+          return true;
+        }
+      }
+
+      put_string(header.name, path.substr(0, sizeof(header.name)));
+      return false;
+    }
+
+    void write_padding(const output_function& output, std::uint64_t size)
+    {
+      constexpr std::array<std::byte, block_size> zeroes{};
+      output(zeroes.data(), std::size_t((block_size - size % block_size) % block_size));
+    }
+
+    // Returns false when the path did not fit into the header, and has to be given in an extended header instead.
+    bool write_header(const output_function& output, std::string_view path, std::uint64_t size, std::int64_t modified_time, char type)
+    {
+      ustar_header header{};
+
+      const auto path_fits = put_path(header, path);
+      put_octal(header.mode, 0644);
+      put_octal(header.user_id, 0);
+      put_octal(header.group_id, 0);
+      put_octal(header.size, size);
+      put_octal(header.modified_time, std::uint64_t(std::max<std::int64_t>(modified_time, 0)));
+      header.type = type;
+      put_string(header.magic, std::string_view("ustar", 6));
+      put_string(header.version, "00");
+
+      // The checksum is calculated with the checksum field itself filled with spaces.
+      std::memset(header.checksum, ' ', sizeof(header.checksum));
+
+      const auto* bytes = reinterpret_cast<const unsigned char*>(&header);
+      std::uint32_t checksum = 0;
+
+      for (auto i = 0u; i < sizeof(header); ++i)
+      {
+        checksum += bytes[i];
+      }
+
+      put_octal(header.checksum, checksum);
+
+      output(reinterpret_cast<const std::byte*>(&header), sizeof(header));
+
+      return path_fits;
+    }
+
+    // A pax record is prefixed with its own length in decimal, including the digits of the length itself.
+    std::string make_pax_record(std::string_view key, std::string_view value)
+    {
+      const auto base_size = key.size() + value.size() + 3;
+      auto size = base_size + 1;
+
+      while (std::to_string(size).size() + base_size != size)
+      {
+        size = std::to_string(size).size() + base_size;
+      }
+
+      return std::to_string(size) + " " + std::string(key) + "=" + std::string(value) + "\n";
+    }
+
+    // Writes everything but the data of an entry, which has to follow with exactly "size" bytes and then its padding.
+    void write_entry_header(const output_function& output, std::string_view path, std::uint64_t size, std::int64_t modified_time)
+    {
+      ustar_header path_header{};
+
+      if (!put_path(path_header, path))
+      {
+        const auto record = make_pax_record("path", path);
+
+        write_header(output, "PaxHeader", record.size(), modified_time, 'x');
+        output(reinterpret_cast<const std::byte*>(record.data()), record.size());
+        write_padding(output, record.size());
+      }
+
+      write_header(output, path, size, modified_time, '0');
+    }
+
+    void write_entry(const output_function& output, std::string_view path, const std::byte* data, std::size_t size, std::int64_t modified_time)
+    {
+      write_entry_header(output, path, size, modified_time);
+      output(data, size);
+      write_padding(output, size);
+    }
+
+    std::int64_t get_unix_time(const std::filesystem::path& path)
+    {
+      std::error_code error;
+      const auto write_time = std::filesystem::last_write_time(path, error);
+
+      if (error)
+      {
+        return 0;
+      }
+
+      const auto system_time = std::chrono::system_clock::now() + std::chrono::duration_cast<std::chrono::system_clock::duration>(write_time - std::filesystem::file_time_type::clock::now());
+
+      return std::chrono::duration_cast<std::chrono::seconds>(system_time.time_since_epoch()).count();
+    }
+  }// namespace
+
+  tar_exporter::tar_exporter(std::basic_ostream<std::byte>& output)
+    : output([&output](const std::byte* data, std::size_t size) { output.write(data, std::streamsize(size)); })
+  {
+  }
+
+  tar_exporter::tar_exporter(std::ostream& output)
+    : output([&output](const std::byte* data, std::size_t size) { output.write(reinterpret_cast<const char*>(data), std::streamsize(size)); })
+  {
+  }
+
+  tar_exporter::statistics tar_exporter::write(const studio::resources::resource_explorer& explorer, const std::vector<studio::resources::file_info>& entries)
+  {
+    statistics result{};
+    std::vector<std::byte> buffer;
+
+    for (auto& [archive_path, volume_entries] : studio::resources::resource_explorer::group_by_archive(entries))
+    {
+      // Loose files are grouped by the folder they are in, which isn't an archive.
+      if (std::filesystem::is_directory(archive_path))
+      {
+        for (const auto& entry : volume_entries)
+        {
+          write_loose_file(explorer, entry, result);
+        }
+
+        continue;
+      }
+
+      auto archive = explorer.get_archive_type(archive_path);
+
+      if (!archive.has_value())
+      {
+        result.failures.push_back({ archive_path, "is not a supported archive" });
+        continue;
+      }
+
+      const auto modified_time = get_unix_time(archive_path);
+
+      std::stable_sort(volume_entries.begin(), volume_entries.end(), [](const auto& a, const auto& b) {
+        return a.offset < b.offset;
+      });
+
+      std::unique_ptr<std::basic_istream<std::byte>> archive_file;
+
+      try
+      {
+        archive_file = explorer.load_file(archive_path).second;
+      }
+      catch (const std::exception& error)
+      {
+        result.failures.push_back({ archive_path, error.what() });
+        continue;
+      }
+
+      for (const auto& entry : volume_entries)
+      {
+        // Entries are decoded in full before their header is written, so a damaged entry leaves nothing behind.
+        buffer.clear();
+
+        try
+        {
+          studio::resources::vector_stream entry_output(buffer);
+          archive->get().extract_file_contents(*archive_file, entry, entry_output);
+        }
+        catch (const std::exception& error)
+        {
+          result.failures.push_back({ entry.folder_path / entry.filename, error.what() });
+          archive_file->clear();
+          continue;
+        }
+
+        const auto path = (explorer.get_extraction_folder({}, entry) / entry.filename).lexically_normal().generic_u8string();
+
+        write_entry(output, path, buffer.data(), buffer.size(), modified_time);
+
+        result.files_written++;
+        result.bytes_written += buffer.size();
+      }
+    }
+
+    return result;
+  }
+
+  void tar_exporter::write_loose_file(const studio::resources::resource_explorer& explorer, const studio::resources::file_info& entry, statistics& result)
+  {
+    const auto file_path = entry.folder_path / entry.filename;
+
+    std::unique_ptr<std::basic_istream<std::byte>> file;
+    std::uint64_t size = 0;
+
+    try
+    {
+      size = std::filesystem::file_size(file_path);
+      file = explorer.load_file(file_path).second;
+    }
+    catch (const std::exception& error)
+    {
+      result.failures.push_back({ file_path, error.what() });
+      return;
+    }
+
+    const auto path = std::filesystem::relative(file_path, explorer.get_search_path()).lexically_normal().generic_u8string();
+
+    write_entry_header(output, path, size, get_unix_time(file_path));
+
+    // The header is already out, so a file which gets shorter while it is read is padded to the size it was given.
+    std::array<std::byte, 65536> buffer{};
+    auto remaining = size;
+
+    while (remaining > 0)
+    {
+      file->read(buffer.data(), std::streamsize(std::min<std::uint64_t>(remaining, buffer.size())));
+      const auto count = std::size_t(file->gcount());
+
+      if (count == 0)
+      {
+        break;
+      }
+
+      output(buffer.data(), count);
+      remaining -= count;
+    }
+
+    if (remaining > 0)
+    {
+      result.failures.push_back({ file_path, "ended before the size it was exported with" });
+
+      buffer.fill(std::byte{});
+
+      while (remaining > 0)
+      {
+        const auto count = std::size_t(std::min<std::uint64_t>(remaining, buffer.size()));
+        output(buffer.data(), count);
+        remaining -= count;
+      }
+    }
+
+    write_padding(output, size);
+
+    result.files_written++;
+    result.bytes_written += size;
+  }
+
+  void tar_exporter::finish()
+  {
+    // The end of the archive is marked by two empty blocks.
+    constexpr std::array<std::byte, block_size * 2> end_of_archive{};
+    output(end_of_archive.data(), end_of_archive.size());
+  }
+}// namespace studio::resources
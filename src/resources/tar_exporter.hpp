@@ -0,0 +1,51 @@
+#ifndef DARKSTARDTSCONVERTER_TAR_EXPORTER_HPP
+#define DARKSTARDTSCONVERTER_TAR_EXPORTER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <functional>
+#include "resource_explorer.hpp"
+
+namespace studio::resources
+{
+  // Streams archive entries into a POSIX tar archive, without writing anything else to disk.
+  // Entries are named after the folders resource_explorer::extract_file_contents would put them in,
+  // and are decoded one at a time straight into the output. Loose files keep their path relative to the search path.
+  class tar_exporter
+  {
+  public:
+    struct failure
+    {
+      std::filesystem::path path;
+      std::string message;
+    };
+
+    struct statistics
+    {
+      std::size_t files_written;
+      std::uint64_t bytes_written;
+      std::vector<failure> failures;
+    };
+
+    explicit tar_exporter(std::basic_ostream<std::byte>& output);
+
+    // For standard output and other narrow streams, which should be opened in binary mode.
+    explicit tar_exporter(std::ostream& output);
+
+    // Entries of several explorers can be written to the same archive, one call after another.
+    // Entries which cannot be read are reported as failures and left out, without stopping the others.
+    statistics write(const studio::resources::resource_explorer& explorer, const std::vector<studio::resources::file_info>& entries);
+
+    // Marks the end of the archive. Nothing can be written afterwards.
+    void finish();
+
+  private:
+    void write_loose_file(const studio::resources::resource_explorer& explorer, const studio::resources::file_info& entry, statistics& result);
+
+    std::function<void(const std::byte*, std::size_t)> output;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_TAR_EXPORTER_HPP
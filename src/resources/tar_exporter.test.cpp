@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+#include <map>
+#include <string>
+#include "tar_exporter.hpp"
+#include "three_space_volume.hpp"
+#include "zip_archive.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+TEST_CASE("Archive entries are streamed into a tar archive", "[resources]")
+{
+  using namespace std::literals;
+  const auto folder = make_test_folder("tar-export");
+  write_file(folder / "simple.vol", single_entry_volume);
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+
+  std::vector<std::byte> output;
+  studio::resources::vector_stream stream(output);
+
+  studio::resources::tar_exporter exporter(stream);
+  const auto result = exporter.write(explorer, explorer.find_files({ ".txt" }));
+  exporter.finish();
+
+  REQUIRE(result.files_written == 1);
+  REQUIRE(output.size() == 512 * 4);
+
+  const auto text = std::string(reinterpret_cast<const char*>(output.data()), output.size());
+
+  REQUIRE(text.substr(0, 17) == "simple/plain.txt\0"sv);
+  REQUIRE(text.substr(124, 12) == "00000000005\0"sv);
+  REQUIRE(text.substr(257, 6) == "ustar\0"sv);
+  REQUIRE(text.substr(512, 6) == "hello\0"sv);
+
+  // The checksum covers the whole header, with the checksum field counted as spaces.
+  auto checksum = 0u;
+
+  for (auto i = 0u; i < 512; ++i)
+  {
+    checksum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(text[i]);
+  }
+
+  REQUIRE(std::stoul(text.substr(148, 7), nullptr, 8) == checksum);
+}
+
+TEST_CASE("Loose files and volume entries are exported together", "[resources]")
+{
+  const auto folder = make_test_folder("tar-export-mixed");
+  write_file(folder / "simple.vol", single_entry_volume);
+  std::filesystem::create_directories(folder / "notes");
+  write_file(folder / "notes" / "loose.txt", "loose file");
+
+  // The stored entry doesn't match its CRC, so it is reported and left out.
+  write_file(folder / "damaged.zip", make_zip({
+    { "bad.txt", 0, to_bytes("bad"), 3, 0 },
+  }));
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+  explorer.add_archive_type(".zip", std::make_unique<studio::resources::zip::zip_file_archive>());
+
+  std::vector<std::byte> output;
+  studio::resources::vector_stream stream(output);
+
+  studio::resources::tar_exporter exporter(stream);
+  const auto result = exporter.write(explorer, explorer.find_files({ ".txt" }));
+  exporter.finish();
+
+  REQUIRE(result.files_written == 2);
+  REQUIRE(result.bytes_written == 15);
+  REQUIRE(result.failures.size() == 1);
+  REQUIRE(result.failures[0].path == folder / "damaged.zip" / "bad.txt");
+
+  const auto text = std::string(reinterpret_cast<const char*>(output.data()), output.size());
+  std::map<std::string, std::string> contents;
+
+  for (std::size_t position = 0; position + 512 <= text.size() && text[position] != '\0';)
+  {
+    const auto name = std::string(text.c_str() + position);
+    const auto size = std::stoul(text.substr(position + 124, 11), nullptr, 8);
+
+    contents.emplace(name, text.substr(position + 512, size));
+    position += 512 + (size + 511) / 512 * 512;
+  }
+
+  REQUIRE(contents == std::map<std::string, std::string>{ { "notes/loose.txt", "loose file" }, { "simple/plain.txt", "hello" } });
+}
@@ -0,0 +1,246 @@
+#include <chrono>
+#include <utility>
+#include <algorithm>
+#include "resources/task_pool.hpp"
+
+namespace studio::resources
+{
+  namespace
+  {
+    // Identifies the queue of the current thread, when it is a worker of a pool.
+    thread_local const task_pool* current_pool = nullptr;
+    thread_local std::size_t current_queue = 0;
+  }// namespace
+
+  task_pool::task_pool(std::size_t worker_count)
+  {
+    worker_count = std::max<std::size_t>(worker_count, 1);
+
+    queues.reserve(worker_count);
+
+    for (auto i = 0u; i < worker_count; ++i)
+    {
+      queues.emplace_back(std::make_unique<task_queue>());
+    }
+
+    workers.reserve(worker_count);
+
+    for (auto i = 0u; i < worker_count; ++i)
+    {
+      workers.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  task_pool::~task_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (auto& worker : workers)
+    {
+      worker.join();
+    }
+  }
+
+  task_pool& task_pool::shared()
+  {
+    static task_pool pool(std::thread::hardware_concurrency());
+    return pool;
+  }
+
+  void task_pool::push(task new_task)
+  {
+    const auto queue_index = current_pool == this ? current_queue : next_queue++ % queues.size();
+
+    queued_count++;
+
+    {
+      std::lock_guard<std::mutex> lock(queues[queue_index]->mutex);
+      queues[queue_index]->tasks.emplace_back(std::move(new_task));
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+
+    wake.notify_one();
+  }
+
+  std::optional<task_pool::task> task_pool::pop(std::size_t queue_index)
+  {
+    auto& queue = *queues[queue_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty())
+    {
+      return std::nullopt;
+    }
+
+    auto result = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued_count--;
+
+    return result;
+  }
+
+  std::optional<task_pool::task> task_pool::steal(std::size_t queue_index)
+  {
+    for (auto i = 1u; i <= queues.size(); ++i)
+    {
+      auto& queue = *queues[(queue_index + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+
+      if (!queue.tasks.empty())
+      {
+        auto result = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued_count--;
+
+        return result;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  bool task_pool::run_one()
+  {
+    auto next = current_pool == this ? pop(current_queue) : std::nullopt;
+
+    if (!next.has_value())
+    {
+      next = steal(current_pool == this ? current_queue : next_queue % queues.size());
+    }
+
+    if (!next.has_value())
+    {
+      return false;
+    }
+
+    (*next)();
+    return true;
+  }
+
+  void task_pool::work(std::size_t queue_index)
+  {
+    current_pool = this;
+    current_queue = queue_index;
+
+    while (true)
+    {
+      if (run_one())
+      {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      wake.wait(lock, [this] { return stopping || queued_count > 0; });
+
+      if (stopping)
+      {
+        return;
+      }
+    }
+  }
+
+  task_group::task_group(task_pool& pool) : pool(pool), state(std::make_shared<shared_state>())
+  {
+  }
+
+  task_group::~task_group()
+  {
+    // Tasks refer to the group, so it cannot go away while any of them are still queued.
+    try
+    {
+      wait();
+    }
+    catch (...)
+    {
+    }
+  }
+
+  void task_group::run(std::function<void()> new_task)
+  {
+    state->pending++;
+
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->queued.emplace_back(std::move(new_task));
+    }
+
+    pool.push([state = state] { run_queued(*state); });
+  }
+
+  bool task_group::run_one()
+  {
+    return run_queued(*state);
+  }
+
+  bool task_group::run_queued(shared_state& state)
+  {
+    std::function<void()> next;
+
+    {
+      // The newest task is taken first, which keeps a recursive crawl mostly depth first like the pool does.
+      std::lock_guard<std::mutex> lock(state.mutex);
+
+      if (state.queued.empty())
+      {
+        return false;
+      }
+
+      next = std::move(state.queued.back());
+      state.queued.pop_back();
+    }
+
+    try
+    {
+      next();
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+
+      if (!state.error)
+      {
+        state.error = std::current_exception();
+      }
+    }
+
+    // The last task has to be finished with the group before a waiting thread is allowed to see it as done.
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    if (--state.pending == 0)
+    {
+      state.done.notify_all();
+    }
+
+    return true;
+  }
+
+  void task_group::wait()
+  {
+    while (state->pending > 0)
+    {
+      if (run_one() || pool.run_one())
+      {
+        continue;
+      }
+
+      // Every remaining task is already running on another thread.
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->done.wait_for(lock, std::chrono::milliseconds(1), [this] { return state->pending == 0; });
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+
+    if (state->error)
+    {
+      std::rethrow_exception(std::exchange(state->error, nullptr));
+    }
+  }
+}// namespace studio::resources
@@ -0,0 +1,99 @@
+#ifndef DARKSTARDTSCONVERTER_TASK_POOL_HPP
+#define DARKSTARDTSCONVERTER_TASK_POOL_HPP
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace studio::resources
+{
+  // A pool of worker threads which each own a queue of tasks.
+  // Workers take the newest task from their own queue, and when it is empty, steal the oldest task of another worker.
+  // Tasks started from inside a task stay on the same worker, which keeps a recursive crawl mostly depth first per thread.
+  class task_pool
+  {
+  public:
+    using task = std::function<void()>;
+
+    explicit task_pool(std::size_t worker_count);
+    ~task_pool();
+
+    task_pool(const task_pool&) = delete;
+    task_pool& operator=(const task_pool&) = delete;
+
+    static task_pool& shared();
+
+    void push(task new_task);
+
+    // Runs a single queued task on the calling thread, if there is one.
+    bool run_one();
+
+  private:
+    struct task_queue
+    {
+      std::mutex mutex;
+      std::deque<task> tasks;
+    };
+
+    std::optional<task> pop(std::size_t queue_index);
+    std::optional<task> steal(std::size_t queue_index);
+    void work(std::size_t queue_index);
+
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic_size_t queued_count = 0;
+    std::atomic_size_t next_queue = 0;
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+  };
+
+  // Tracks a set of tasks which may start more tasks of their own, so that a caller can wait for all of them.
+  // A waiting thread runs queued tasks itself instead of blocking, which means groups can also be waited on from inside a task.
+  // Tasks are kept by the group and the pool only holds a reference to them, so a thread can help with one group
+  // without picking up unrelated work. A reference which outlives the task it was for does nothing.
+  class task_group
+  {
+  public:
+    explicit task_group(task_pool& pool);
+    ~task_group();
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    void run(std::function<void()> new_task);
+
+    // Runs a single queued task of this group on the calling thread, if there is one.
+    bool run_one();
+
+    // Waits for every task of the group, and rethrows the first exception thrown by any of them.
+    void wait();
+
+  private:
+    struct shared_state
+    {
+      std::atomic_size_t pending = 0;
+
+      std::mutex mutex;
+      std::condition_variable done;
+      std::deque<std::function<void()>> queued;
+      std::exception_ptr error;
+    };
+
+    static bool run_queued(shared_state& state);
+
+    task_pool& pool;
+    std::shared_ptr<shared_state> state;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_TASK_POOL_HPP
@@ -0,0 +1,154 @@
+#ifndef DARKSTARDTSCONVERTER_TEST_FIXTURES_HPP
+#define DARKSTARDTSCONVERTER_TEST_FIXTURES_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <filesystem>
+#include <string_view>
+#include <nonstd/span.hpp>
+#include "crc32.hpp"
+
+// Files and helpers shared by the tests of the resources library.
+namespace studio::resources::test
+{
+  using namespace std::literals;
+
+  // A VOLN volume with no folders and one uncompressed file, "plain.txt", containing "hello".
+  constexpr auto single_entry_volume = "VOLN\0\0\0\0\0\0\0\0"
+                                       "\x01\0\0\0\0\0"
+                                       "plain.txt\0\0\0\0\0"
+                                       "\x24\0\0\0"
+                                       "\x02\x05\0\0\0\0\0\0\0"
+                                       "hello"sv;
+
+  // A VOLN volume where "first.txt", containing "ab", is directly followed by "second.txt", containing "cde".
+  constexpr auto two_entry_volume = "VOLN\0\0\0\0\0\0\0\0"
+                                    "\x02\0\0\0\0\0"
+                                    "first.txt\0\0\0\0\0"
+                                    "\x36\0\0\0"
+                                    "second.txt\0\0\0\0"
+                                    "\x41\0\0\0"
+                                    "\x02\x02\0\0\0\0\0\0\0"
+                                    "ab"
+                                    "\x02\x03\0\0\0\0\0\0\0"
+                                    "cde"sv;
+
+  // An empty folder under the temporary directory, removing whatever an earlier run left in it.
+  inline std::filesystem::path make_test_folder(std::string_view name)
+  {
+    auto folder = std::filesystem::temp_directory_path() / "3space-studio-tests" / name;
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+    return folder;
+  }
+
+  inline void write_file(const std::filesystem::path& path, std::string_view contents)
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(contents.data(), std::streamsize(contents.size()));
+  }
+
+  inline std::string read_file(const std::filesystem::path& path)
+  {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+  }
+
+  inline std::string to_string(nonstd::span<const std::byte> values)
+  {
+    return std::string(reinterpret_cast<const char*>(values.data()), values.size());
+  }
+
+  inline std::vector<std::byte> to_bytes(std::string_view values)
+  {
+    const auto* start = reinterpret_cast<const std::byte*>(values.data());
+    return std::vector<std::byte>(start, start + values.size());
+  }
+
+  inline std::string to_uint32(std::uint32_t value)
+  {
+    return std::string{ char(value & 0xff), char((value >> 8) & 0xff), char((value >> 16) & 0xff), char(value >> 24) };
+  }
+
+  // An RMF file, "test.rmf", and its two volumes. "first.vol" has "a.txt" and "b.txt", containing "abc" and "de",
+  // which the RMF file lists out of order, and "second.vol" has "c.txt", also containing "abc".
+  inline void write_rmf_volumes(const std::filesystem::path& folder)
+  {
+    write_file(folder / "test.rmf", "\0\x01\x05\x07\x02\0"s
+                                      + "first.vol\0\0\0\0\x02\0"s + to_uint32(1) + to_uint32(24) + to_uint32(2) + to_uint32(0)
+                                      + "second.vol\0\0\0\x01\0"s + to_uint32(3) + to_uint32(0));
+
+    write_file(folder / "first.vol", "a.txt\0\0\0\0\0\0\0\0\x03\0\0\0abc\0\0\0\0b.txt\0\0\0\0\0\0\0\0\x02\0\0\0de"sv);
+    write_file(folder / "second.vol", "c.txt\0\0\0\0\0\0\0\0\x03\0\0\0abc"sv);
+  }
+
+  struct zip_entry
+  {
+    std::string name;
+    std::uint16_t method;
+    std::vector<std::byte> data;
+    std::size_t size;
+
+    // The CRC of the uncompressed contents, which for stored entries is worked out from "data".
+    std::optional<std::uint32_t> crc = std::nullopt;
+  };
+
+  // A zip file with only the fields which the reader relies on filled in.
+  inline std::string make_zip(const std::vector<zip_entry>& entries)
+  {
+    auto put_value = [](std::string& output, auto value) {
+      for (auto i = 0u; i < sizeof(value); ++i)
+      {
+        output.push_back(char((value >> (i * 8)) & 0xff));
+      }
+    };
+
+    std::string output;
+    std::string directory;
+
+    for (const auto& entry : entries)
+    {
+      const auto offset = std::uint32_t(output.size());
+
+      put_value(output, std::uint32_t(0x04034b50));
+      output.append(22, '\0');
+      put_value(output, std::uint16_t(entry.name.size()));
+      put_value(output, std::uint16_t(0));
+      output += entry.name;
+      output.append(reinterpret_cast<const char*>(entry.data.data()), entry.data.size());
+
+      put_value(directory, std::uint32_t(0x02014b50));
+      directory.append(6, '\0');
+      put_value(directory, entry.method);
+      directory.append(4, '\0');
+      put_value(directory, entry.crc.value_or(studio::resources::crc32(nonstd::span<const std::byte>(entry.data.data(), entry.data.size()))));
+      put_value(directory, std::uint32_t(entry.data.size()));
+      put_value(directory, std::uint32_t(entry.size));
+      put_value(directory, std::uint16_t(entry.name.size()));
+      directory.append(12, '\0');
+      put_value(directory, offset);
+      directory += entry.name;
+    }
+
+    const auto directory_offset = std::uint32_t(output.size());
+    output += directory;
+
+    put_value(output, std::uint32_t(0x06054b50));
+    put_value(output, std::uint32_t(0));
+    put_value(output, std::uint16_t(entries.size()));
+    put_value(output, std::uint16_t(entries.size()));
+    put_value(output, std::uint32_t(directory.size()));
+    put_value(output, directory_offset);
+    put_value(output, std::uint16_t(0));
+
+    return output;
+  }
+}// namespace studio::resources::test
+
+#endif//DARKSTARDTSCONVERTER_TEST_FIXTURES_HPP
@@ -0,0 +1,120 @@
+#include <map>
+#include <mutex>
+#include <iterator>
+#include <algorithm>
+#include "resources/three_space_checksums.hpp"
+#include "resources/mapped_file.hpp"
+#include "resources/memory_stream.hpp"
+#include "resources/crc32.hpp"
+
+namespace studio::resources::vol::three_space
+{
+  namespace
+  {
+    // Finds the entries of every volume first, so that volumes shared by several RMF files are only read once.
+    std::map<std::filesystem::path, std::vector<checksum_entry>> get_volumes(const std::vector<std::filesystem::path>& archive_paths, checksum_report& report)
+    {
+      std::map<std::filesystem::path, std::vector<checksum_entry>> results;
+
+      for (const auto& archive_path : archive_paths)
+      {
+        try
+        {
+          auto mapping = std::make_shared<const studio::resources::mapped_file>(archive_path);
+          studio::resources::memory_stream stream(mapping->data(), mapping);
+
+          if (!(rmf_file_archive::is_supported(stream) || dyn_file_archive::is_supported(stream)))
+          {
+            continue;
+          }
+
+          for (auto& entry : get_checksum_entries(stream, archive_path))
+          {
+            auto& entries = results[entry.volume_path];
+            entries.emplace_back(std::move(entry));
+          }
+        }
+        catch (const std::exception& error)
+        {
+          report.failures.emplace_back(archive_path, error.what());
+        }
+      }
+
+      return results;
+    }
+  }// namespace
+
+  checksum_report compare_checksums(const std::vector<std::filesystem::path>& archive_paths, studio::resources::task_pool& pool)
+  {
+    checksum_report report{};
+    auto volumes = get_volumes(archive_paths, report);
+
+    std::mutex report_mutex;
+    studio::resources::task_group comparisons(pool);
+
+    for (auto& volume : volumes)
+    {
+      comparisons.run([&volume, &report, &report_mutex] {
+        std::vector<checksum_mismatch> mismatches;
+        std::size_t files_checked = 0;
+        std::uint64_t bytes_checked = 0;
+
+        try
+        {
+          const studio::resources::mapped_file mapping(volume.first);
+          const auto data = mapping.data();
+
+          auto& entries = volume.second;
+
+          std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a.data_offset < b.data_offset;
+          });
+
+          // The same entry is listed more than once when several of the inputs refer to the same volume.
+          entries.erase(std::unique(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a.data_offset == b.data_offset;
+          }), entries.end());
+
+          for (auto& entry : entries)
+          {
+            if (entry.data_offset > data.size() || entry.info.size > data.size() - entry.data_offset)
+            {
+              std::lock_guard<std::mutex> lock(report_mutex);
+              report.failures.emplace_back(volume.first / entry.info.filename, "extends past the end of the volume");
+              continue;
+            }
+
+            const auto actual = studio::resources::crc32(data.subspan(entry.data_offset, entry.info.size));
+
+            files_checked++;
+            bytes_checked += entry.info.size;
+
+            if (actual != entry.checksum)
+            {
+              mismatches.push_back({ std::move(entry.info), volume.first, entry.checksum, actual });
+            }
+          }
+        }
+        catch (const std::exception& error)
+        {
+          std::lock_guard<std::mutex> lock(report_mutex);
+          report.failures.emplace_back(volume.first, error.what());
+        }
+
+        std::lock_guard<std::mutex> lock(report_mutex);
+        report.files_checked += files_checked;
+        report.bytes_checked += bytes_checked;
+        std::move(mismatches.begin(), mismatches.end(), std::back_inserter(report.mismatches));
+      });
+    }
+
+    comparisons.wait();
+
+    // Tasks finish in any order, but the report shouldn't.
+    std::sort(report.mismatches.begin(), report.mismatches.end(), [](const auto& a, const auto& b) {
+      return a.volume_path != b.volume_path ? a.volume_path < b.volume_path : a.info.offset < b.info.offset;
+    });
+
+    return report;
+  }
+}// namespace studio::resources::vol::three_space
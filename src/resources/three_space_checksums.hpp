@@ -0,0 +1,38 @@
+#ifndef DARKSTARDTSCONVERTER_THREE_SPACE_CHECKSUMS_HPP
+#define DARKSTARDTSCONVERTER_THREE_SPACE_CHECKSUMS_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "three_space_volume.hpp"
+#include "task_pool.hpp"
+
+namespace studio::resources::vol::three_space
+{
+  struct checksum_mismatch
+  {
+    studio::resources::file_info info;
+    std::filesystem::path volume_path;
+    std::uint32_t expected;
+    std::uint32_t actual;
+  };
+
+  struct checksum_report
+  {
+    std::size_t files_checked;
+    std::uint64_t bytes_checked;
+    std::vector<checksum_mismatch> mismatches;
+    std::vector<std::pair<std::filesystem::path, std::string>> failures;
+  };
+
+  // Compares the CRC32 of the contents of each entry with the checksum its RMF or DYN index keeps for it.
+  // Every volume is read by its own task, straight from a memory mapping of it. Files which are neither RMF nor DYN are skipped.
+  // The checksums haven't been confirmed to be CRC32 against shipped volumes yet, so a mismatch only means that the entry
+  // differs from its checksum under that assumption, not that it is damaged.
+  checksum_report compare_checksums(const std::vector<std::filesystem::path>& archive_paths,
+    studio::resources::task_pool& pool = studio::resources::task_pool::shared());
+}// namespace studio::resources::vol::three_space
+
+#endif//DARKSTARDTSCONVERTER_THREE_SPACE_CHECKSUMS_HPP
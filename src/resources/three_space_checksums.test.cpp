@@ -0,0 +1,92 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+#include <utility>
+#include "three_space_checksums.hpp"
+#include "crc32.hpp"
+#include "test_fixtures.hpp"
+
+namespace
+{
+  std::uint32_t crc_text(std::string_view text)
+  {
+    return studio::resources::crc32(nonstd::span<const std::byte>(reinterpret_cast<const std::byte*>(text.data()), text.size()));
+  }
+
+  void append_uint32(std::string& output, std::uint32_t value)
+  {
+    for (auto i = 0; i < 4; ++i)
+    {
+      output.push_back(char((value >> (i * 8)) & 0xff));
+    }
+  }
+
+  // A DYN volume with the given checksums in its header, followed by entries with the given names and contents.
+  std::string make_dyn_volume(const std::vector<std::uint32_t>& checksums, const std::vector<std::pair<std::string_view, std::string_view>>& entries)
+  {
+    using namespace std::literals;
+
+    auto volume = std::string("Dynamix Volume File\0"sv) + std::string(12, '\0');
+    append_uint32(volume, std::uint32_t(checksums.size()));
+
+    for (auto checksum : checksums)
+    {
+      append_uint32(volume, checksum);
+    }
+
+    for (auto [name, contents] : entries)
+    {
+      volume += std::string(name) + std::string(13 - name.size(), '\0');
+      append_uint32(volume, std::uint32_t(contents.size()));
+      volume += contents;
+      volume.append((4 - volume.size() % 4) % 4, '\0');
+    }
+
+    return volume;
+  }
+}// namespace
+
+TEST_CASE("CRC32 matches the standard check value", "[vol.three_space]")
+{
+  REQUIRE(crc_text("123456789") == 0xcbf43926u);
+  REQUIRE(crc_text("") == 0);
+
+  // Continuing a checksum gives the same result as calculating it in one go.
+  REQUIRE(studio::resources::crc32(nonstd::span<const std::byte>(reinterpret_cast<const std::byte*>("56789"), 5), crc_text("1234")) == 0xcbf43926u);
+}
+
+TEST_CASE("DYN entries which don't match their checksum are reported", "[vol.three_space]")
+{
+  using namespace std::literals;
+  const auto folder = studio::resources::test::make_test_folder("checksums");
+
+  studio::resources::test::write_file(folder / "test.dyn", make_dyn_volume({ crc_text("hello"), crc_text("world") }, { { "good.txt"sv, "hello"sv }, { "bad.txt"sv, "wurld"sv } }));
+
+  const auto report = studio::resources::vol::three_space::compare_checksums({ folder / "test.dyn" });
+
+  REQUIRE(report.failures.empty());
+  REQUIRE(report.files_checked == 2);
+  REQUIRE(report.bytes_checked == 10);
+  REQUIRE(report.mismatches.size() == 1);
+  REQUIRE(report.mismatches[0].info.filename == "bad.txt");
+  REQUIRE(report.mismatches[0].expected == crc_text("world"));
+  REQUIRE(report.mismatches[0].actual == crc_text("wurld"));
+}
+
+TEST_CASE("Every entry which differs from its checksum is reported on its own", "[vol.three_space]")
+{
+  using namespace std::literals;
+  const auto folder = studio::resources::test::make_test_folder("checksums-all-different");
+
+  studio::resources::test::write_file(folder / "test.dyn", make_dyn_volume({ 1, 2 }, { { "first.txt"sv, "hello"sv }, { "second.txt"sv, "world"sv } }));
+
+  const auto report = studio::resources::vol::three_space::compare_checksums({ folder / "test.dyn" });
+
+  REQUIRE(report.files_checked == 2);
+  REQUIRE(report.failures.empty());
+  REQUIRE(report.mismatches.size() == 2);
+  REQUIRE(report.mismatches[0].info.filename == "first.txt");
+  REQUIRE(report.mismatches[0].expected == 1);
+  REQUIRE(report.mismatches[1].info.filename == "second.txt");
+  REQUIRE(report.mismatches[1].expected == 2);
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstring>
+#include "resources/three_space_compression.hpp"
+
+namespace studio::resources::vol::three_space
+{
+  constexpr std::size_t min_match_size = 3;
+
+  std::vector<std::byte> decompress_lz(nonstd::span<const std::byte> input, std::size_t uncompressed_size)
+  {
+    std::vector<std::byte> output(uncompressed_size, std::byte{});
+
+    auto* out = output.data();
+    const auto* const out_end = output.data() + output.size();
+
+    const auto* in = input.data();
+    const auto* const in_end = input.data() + input.size();
+
+    // Each control byte describes the next 8 items, starting with the low bit.
+    // A set bit is a literal byte, otherwise two bytes follow with a 12-bit distance back
+    // into the output and a 4-bit length.
+    while (out < out_end && in < in_end)
+    {
+      auto flags = std::to_integer<unsigned>(*in++);
+
+      for (auto bit = 0; bit < 8 && out < out_end; ++bit, flags >>= 1)
+      {
+        if (flags & 1)
+        {
+          if (in == in_end)
+          {
+            break;
+          }
+
+          *out++ = *in++;
+          continue;
+        }
+
+        if (in_end - in < 2)
+        {
+          in = in_end;
+          break;
+        }
+
+        const auto low = std::to_integer<std::size_t>(in[0]);
+        const auto high = std::to_integer<std::size_t>(in[1]);
+        in += 2;
+
+        const auto distance = (low | ((high & 0xf0) << 4)) + 1;
+        const auto length = std::min<std::size_t>((high & 0x0f) + min_match_size, std::size_t(out_end - out));
+
+        const auto written = std::size_t(out - output.data());
+
+        if (distance > written)
+        {
+          // References before the start of the entry read from an empty window, which is assumed to hold zeroes.
+          // The output was zero initialised, so only the position needs to move.
+          const auto skipped = std::min(distance - written, length);
+          out += skipped;
+
+          if (skipped == length)
+          {
+            continue;
+          }
+
+          const auto source = output.data();
+          for (auto i = skipped; i < length; ++i)
+          {
+            *out++ = source[i - skipped];
+          }
+          continue;
+        }
+
+        const auto* source = out - distance;
+
+        if (distance >= length)
+        {
+          std::memcpy(out, source, length);
+          out += length;
+        }
+        else
+        {
+          // Overlapping matches repeat the most recent bytes, so they must be copied one at a time.
+          for (auto i = 0u; i < length; ++i)
+          {
+            *out++ = source[i];
+          }
+        }
+      }
+    }
+
+    output.resize(std::size_t(out - output.data()));
+
+    return output;
+  }
+}// namespace studio::resources::vol::three_space
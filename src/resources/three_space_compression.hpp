@@ -0,0 +1,19 @@
+#ifndef DARKSTARDTSCONVERTER_THREE_SPACE_COMPRESSION_HPP
+#define DARKSTARDTSCONVERTER_THREE_SPACE_COMPRESSION_HPP
+
+#include <vector>
+#include <cstddef>
+#include <nonstd/span.hpp>
+
+namespace studio::resources::vol::three_space
+{
+  // Decodes the LZ variant used by VOLN entries tagged with 0x09.
+  // The entire compressed entry is expected as input, and because the output is
+  // allocated up front from the size in the entry header, matches are copied from the output itself
+  // instead of a separate sliding window.
+  // The format is provisional, since it hasn't been checked against a shipped volume. In particular, matches which reach
+  // before the start of the entry read zeroes here, while LZSS variants of the time usually start from a window of spaces.
+  std::vector<std::byte> decompress_lz(nonstd::span<const std::byte> input, std::size_t uncompressed_size);
+}// namespace studio::resources::vol::three_space
+
+#endif//DARKSTARDTSCONVERTER_THREE_SPACE_COMPRESSION_HPP
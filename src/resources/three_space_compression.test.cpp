@@ -0,0 +1,169 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include "three_space_compression.hpp"
+#include "three_space_volume.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+TEST_CASE("3Space LZ data is decoded correctly", "[vol.three_space]")
+{
+  // Three literals, a nine byte match three bytes back, and three more literals.
+  auto packed = to_bytes("\x77" "abc" "\x02\x06" "XYZ");
+
+  auto result = studio::resources::vol::three_space::decompress_lz(packed, 15);
+
+  REQUIRE(to_string({ result.data(), result.size() }) == "abcabcabcabcXYZ");
+}
+
+TEST_CASE("3Space LZ output never exceeds the expected size", "[vol.three_space]")
+{
+  auto packed = to_bytes("\x77" "abc" "\x02\x06" "XYZ");
+
+  auto result = studio::resources::vol::three_space::decompress_lz(packed, 5);
+
+  REQUIRE(to_string({ result.data(), result.size() }) == "abcab");
+}
+
+TEST_CASE("Compressed VOLN entries are extracted", "[vol.three_space]")
+{
+  using namespace std::literals;
+  auto packed = "\x77" "abc" "\x02\x06" "XYZ"sv;
+
+  std::basic_stringstream<std::byte> volume;
+  auto write = [&](std::string_view value) { volume.write(reinterpret_cast<const std::byte*>(value.data()), value.size()); };
+
+  // Header with no folders, followed by a directory with a single file and then the entry itself.
+  write("VOLN\0\0\0\0\0\0\0\0"sv);
+  write("\x01\0\0\0\0\0"sv);
+  write("packed.txt\0\0\0\0"sv);
+  write("\x24\0\0\0"sv);
+  write("\x09\x09\0\0\0\x0f\0\0\0"sv);
+  write(packed);
+
+  studio::resources::vol::three_space::vol_file_archive archive;
+  auto listing = archive.get_content_listing(volume, "missing-folder/packed.vol");
+
+  REQUIRE(listing.size() == 1);
+
+  auto& info = std::get<studio::resources::file_info>(listing.front());
+  REQUIRE(info.size == 15);
+  REQUIRE(info.compression_type == studio::resources::compression_type::lz);
+
+  std::basic_stringstream<std::byte> output;
+  archive.extract_file_contents(volume, info, output);
+
+  REQUIRE(to_string(output.str()) == "abcabcabcabcXYZ");
+}
+
+TEST_CASE("DYN entries are listed and extracted", "[vol.three_space]")
+{
+  using namespace std::literals;
+
+  std::basic_stringstream<std::byte> volume;
+  auto write = [&](std::string_view value) { volume.write(reinterpret_cast<const std::byte*>(value.data()), value.size()); };
+  auto write_uint32 = [&](std::uint32_t value) {
+    for (auto i = 0; i < 4; ++i)
+    {
+      volume.put(std::byte((value >> (i * 8)) & 0xff));
+    }
+  };
+
+  // Sizes which need every amount of padding, and an entry larger than the chunks headers are read in.
+  const auto contents = std::vector<std::string>{ "a", "bc", "def", "ghij", std::string(100000, 'x'), "klmno" };
+
+  write("Dynamix Volume File\0"sv);
+  write(std::string(12, '\0'));
+  write_uint32(std::uint32_t(contents.size()));
+
+  for (auto i = 0u; i < contents.size(); ++i)
+  {
+    write_uint32(i);
+  }
+
+  for (auto i = 0u; i < contents.size(); ++i)
+  {
+    const auto name = "file" + std::to_string(i) + ".txt";
+    write(name + std::string(13 - name.size(), '\0'));
+    write_uint32(std::uint32_t(contents[i].size()));
+    write(contents[i]);
+    write(std::string((4 - (13 + 4 + contents[i].size()) % 4) % 4, '\0'));
+  }
+
+  studio::resources::vol::three_space::dyn_file_archive archive;
+  volume.seekg(0);
+  auto listing = archive.get_content_listing(volume, "test.dyn");
+
+  REQUIRE(listing.size() == contents.size());
+
+  for (auto i = 0u; i < contents.size(); ++i)
+  {
+    auto& info = std::get<studio::resources::file_info>(listing[i]);
+    REQUIRE(info.filename == "file" + std::to_string(i) + ".txt");
+    REQUIRE(info.size == contents[i].size());
+
+    std::basic_stringstream<std::byte> output;
+    volume.clear();
+    archive.extract_file_contents(volume, info, output);
+
+    REQUIRE(to_string(output.str()) == contents[i]);
+  }
+}
+
+TEST_CASE("RMF volumes are listed from a single read of the index", "[vol.three_space]")
+{
+  const auto folder = studio::resources::test::make_test_folder("rmf");
+  studio::resources::test::write_rmf_volumes(folder);
+
+  const auto rmf_contents = studio::resources::test::read_file(folder / "test.rmf");
+
+  studio::resources::vol::three_space::rmf_file_archive archive;
+
+  auto list = [&](std::string_view volume) {
+    std::basic_stringstream<std::byte> stream(std::basic_string<std::byte>(reinterpret_cast<const std::byte*>(rmf_contents.data()), rmf_contents.size()));
+    return archive.get_content_listing(stream, folder / "test.rmf" / volume);
+  };
+
+  auto first = list("first.vol");
+  REQUIRE(first.size() == 2);
+  REQUIRE(std::get<studio::resources::file_info>(first[0]).filename == "a.txt");
+  REQUIRE(std::get<studio::resources::file_info>(first[0]).size == 3);
+  REQUIRE(std::get<studio::resources::file_info>(first[1]).filename == "b.txt");
+  REQUIRE(std::get<studio::resources::file_info>(first[1]).offset == 24);
+  REQUIRE(std::get<studio::resources::file_info>(first[1]).folder_path == folder / "test.rmf" / "first.vol");
+
+  auto second = list("second.vol");
+  REQUIRE(second.size() == 1);
+  REQUIRE(std::get<studio::resources::file_info>(second[0]).filename == "c.txt");
+}
+
+TEST_CASE("VOLN entries keep the order of the directory", "[vol.three_space]")
+{
+  using namespace std::literals;
+
+  std::basic_stringstream<std::byte> volume;
+  auto write = [&](std::string_view value) { volume.write(reinterpret_cast<const std::byte*>(value.data()), value.size()); };
+
+  // The directory lists the entry stored last first.
+  write("VOLN\0\0\0\0\0\0\0\0"sv);
+  write("\x02\0\0\0\0\0"sv);
+  write("later.txt\0\0\0\0\0"sv);
+  write("\x41\0\0\0"sv);
+  write("early.txt\0\0\0\0\0"sv);
+  write("\x36\0\0\0"sv);
+  write("\x02\x02\0\0\0\0\0\0\0"sv);
+  write("ab"sv);
+  write("\x02\x03\0\0\0\0\0\0\0"sv);
+  write("cde"sv);
+
+  studio::resources::vol::three_space::vol_file_archive archive;
+  auto listing = archive.get_content_listing(volume, "missing-folder/ordered.vol");
+
+  REQUIRE(listing.size() == 2);
+  REQUIRE(std::get<studio::resources::file_info>(listing[0]).filename == "later.txt");
+  REQUIRE(std::get<studio::resources::file_info>(listing[0]).size == 3);
+  REQUIRE(std::get<studio::resources::file_info>(listing[1]).filename == "early.txt");
+  REQUIRE(std::get<studio::resources::file_info>(listing[1]).size == 2);
+}
@@ -4,8 +4,13 @@
 #include <optional>
 #include <utility>
 #include <string>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 
 #include "three_space_volume.hpp"
+#include "three_space_compression.hpp"
+#include "shared_file.hpp"
 
 namespace studio::resources::vol::three_space
 {
@@ -65,9 +70,97 @@ namespace studio::resources::vol::three_space
     return results;
   }
 
-  std::vector<studio::resources::file_info> get_rmf_data(std::basic_istream<std::byte>& raw_data, const std::filesystem::path& archive_path)
+  // Entries of both RMF volumes and DYN files start with a 13 character name, followed by their size.
+  constexpr auto entry_header_size = sizeof(std::array<std::byte, 13>) + sizeof(endian::little_int32_t);
+
+  // Reads fixed size headers at the offsets of a sorted range of items. Headers close to each other are read together,
+  // up to 1 MB at a time, so that a volume full of small entries only takes a few reads.
+  // Items whose header is past the end of the data are parsed with a null header.
+  template<typename Iterator, typename GetOffset, typename Read, typename Parse>
+  void read_header_batches(Iterator begin, Iterator end, std::size_t header_size, GetOffset get_offset, Read read, Parse parse)
   {
-    std::vector<studio::resources::file_info> results;
+    constexpr std::uint64_t max_batch_size = 1024 * 1024;
+    constexpr std::uint64_t max_gap = 64 * 1024;
+
+    std::vector<std::byte> batch;
+
+    for (auto first = begin; first != end;)
+    {
+      const auto batch_start = std::uint64_t(get_offset(*first));
+      auto batch_end = batch_start + header_size;
+      auto last = std::next(first);
+
+      for (; last != end; ++last)
+      {
+        const auto offset = std::uint64_t(get_offset(*last));
+
+        if (offset > batch_end + max_gap || offset + header_size - batch_start > max_batch_size)
+        {
+          break;
+        }
+
+        batch_end = std::max(batch_end, offset + header_size);
+      }
+
+      batch.resize(std::size_t(batch_end - batch_start));
+      batch.resize(read(batch_start, batch.data(), batch.size()));
+
+      for (; first != last; ++first)
+      {
+        const auto offset = std::uint64_t(get_offset(*first));
+        const auto available = offset + header_size <= batch_start + batch.size();
+
+        parse(*first, available ? batch.data() + (offset - batch_start) : nullptr);
+      }
+    }
+  }
+
+  void read_rmf_entries(const std::filesystem::path& volume_path, const std::vector<rmf_file_header>& headers, rmf_index::volume& volume)
+  {
+    if (headers.empty() || !std::filesystem::exists(volume_path))
+    {
+      return;
+    }
+
+    const studio::resources::shared_file file(volume_path);
+
+    volume.entries.reserve(headers.size());
+    volume.checksums.reserve(headers.size());
+
+    read_header_batches(
+      headers.begin(),
+      headers.end(),
+      entry_header_size,
+      [](const auto& file_header) { return std::uint32_t(file_header.offset); },
+      [&](auto offset, auto* output, auto count) { return file.read_at(offset, output, count); },
+      [&](const auto& file_header, const std::byte* header) {
+        // Entries past the end of a truncated volume are left out.
+        if (!header)
+        {
+          return;
+        }
+
+        const auto* name = reinterpret_cast<const char*>(header);
+
+        endian::little_uint32_t file_size{};
+        std::memcpy(&file_size, header + sizeof(std::array<std::byte, 13>), sizeof(file_size));
+
+        studio::resources::file_info info{};
+        info.offset = std::uint32_t(file_header.offset);
+        info.filename = std::string(name, std::find(name, name + 13, '\0'));
+        info.size = file_size;
+        info.compression_type = studio::resources::compression_type::none;
+
+        volume.entries.emplace_back(std::move(info));
+        volume.checksums.emplace_back(std::uint32_t(file_header.checksum));
+      });
+  }
+
+  rmf_index read_rmf_index(std::basic_istream<std::byte>& raw_data, const std::filesystem::path& rmf_path)
+  {
+    rmf_index result;
+    result.stamp = studio::resources::get_file_stamp(rmf_path);
+
     std::array<std::byte, 6> header{};
     raw_data.read(header.data(), sizeof(header));
 
@@ -75,9 +168,8 @@ namespace studio::resources::vol::three_space
 
     std::array<char, 14> filename{ '\0' };
 
-    auto real_path = archive_path.parent_path().parent_path();
-    auto map_filename = archive_path.parent_path().filename().string();
-    auto volume_filename = archive_path.filename().string();
+    // The volumes themselves are found next to the RMF file.
+    const auto real_path = rmf_path.parent_path();
 
     for (auto i = 0; i < volume_count; ++i)
     {
@@ -86,54 +178,41 @@ namespace studio::resources::vol::three_space
       endian::little_uint16_t file_count{};
       raw_data.read(reinterpret_cast<std::byte*>(&file_count), sizeof(file_count));
 
-      if (volume_filename == std::string_view(filename.data()))
-      {
-        std::vector<rmf_file_header> headers(file_count, rmf_file_header{});
-
-        raw_data.read(reinterpret_cast<std::byte*>(headers.data()), file_count * sizeof(rmf_file_header));
-
-        std::sort(headers.begin(), headers.end(), [](const auto& a, const auto& b) {
-          return a.offset < b.offset;
-        });
-
-        results.reserve(file_count);
-
-        auto volume = std::basic_ifstream<std::byte>{ real_path / volume_filename, std::ios::binary };
+      std::vector<rmf_file_header> headers(file_count, rmf_file_header{});
+      raw_data.read(reinterpret_cast<std::byte*>(headers.data()), file_count * sizeof(rmf_file_header));
 
-        std::array<char, 14> child_filename{ '\0' };
-
-        for (auto x = 0; x < file_count; ++x)
-        {
-          auto& file_header = headers[x];
-
-          volume.seekg(file_header.offset, std::ios::beg);
-
-          volume.read(reinterpret_cast<std::byte*>(child_filename.data()), child_filename.size() - 1);
-          endian::little_uint32_t file_size{};
-          volume.read(reinterpret_cast<std::byte*>(&file_size), sizeof(file_size));
+      std::sort(headers.begin(), headers.end(), [](const auto& a, const auto& b) {
+        return std::uint32_t(a.offset) < std::uint32_t(b.offset);
+      });
 
-          studio::resources::file_info info{};
-          info.offset = file_header.offset;
-          info.filename = child_filename.data();
-          info.size = file_size;
-          info.folder_path = real_path / map_filename / volume_filename;
-          info.compression_type = studio::resources::compression_type::none;
+      auto& volume = result.volumes.emplace_back();
+      volume.name = filename.data();
+      volume.stamp = studio::resources::get_file_stamp(real_path / volume.name);
 
-          results.emplace_back(info);
-        }
+      read_rmf_entries(real_path / volume.name, headers, volume);
 
-        break;
-      }
-      else
+      for (auto& entry : volume.entries)
       {
-        raw_data.seekg(file_count * sizeof(rmf_file_header), std::ios::cur);
+        entry.folder_path = rmf_path / volume.name;
       }
     }
 
-    return results;
+    return result;
   }
 
-  std::vector<studio::resources::file_info> get_dyn_data(std::basic_istream<std::byte>& raw_data)
+  bool rmf_index::is_current(const std::filesystem::path& rmf_path) const
+  {
+    if (studio::resources::get_file_stamp(rmf_path) != stamp)
+    {
+      return false;
+    }
+
+    return std::all_of(volumes.begin(), volumes.end(), [&](const auto& volume) {
+      return studio::resources::get_file_stamp(rmf_path.parent_path() / volume.name) == volume.stamp;
+    });
+  }
+
+  std::vector<studio::resources::file_info> get_dyn_data(std::basic_istream<std::byte>& raw_data, std::vector<std::uint32_t>* checksums = nullptr)
   {
     std::array<std::byte, 20> header{};
     raw_data.read(header.data(), sizeof(header));
@@ -149,41 +228,63 @@ namespace studio::resources::vol::three_space
 
     raw_data.read(reinterpret_cast<std::byte*>(&file_count), sizeof(file_count));
 
-    // The section being skipped appears to be an array of checksums.
-    // TODO verify if the checksums are crc32.
-    raw_data.seekg(file_count * sizeof(std::array<std::byte, 4>), std::ios::cur);
-
-    std::array<char, 14> child_filename{ '\0' };
+    // The section being skipped appears to be an array of checksums, one for each entry.
+    if (checksums)
+    {
+      std::vector<endian::little_uint32_t> raw_checksums(file_count);
+      raw_data.read(reinterpret_cast<std::byte*>(raw_checksums.data()), raw_checksums.size() * sizeof(endian::little_uint32_t));
+      checksums->assign(raw_checksums.begin(), raw_checksums.end());
+    }
+    else
+    {
+      raw_data.seekg(file_count * sizeof(std::array<std::byte, 4>), std::ios::cur);
+    }
 
     std::vector<studio::resources::file_info> results;
     results.reserve(file_count);
 
+    // Entries follow each other, each starting on a multiple of 4 bytes. Their headers are parsed out of large chunks of the file,
+    // which is only read again once the next header is outside of the current chunk, such as after a large entry.
+    constexpr std::size_t chunk_size = 64 * 1024;
+
+    std::vector<std::byte> chunk;
+    std::size_t chunk_offset = 0;
+    auto next_offset = std::size_t(raw_data.tellg());
+
     for (auto x = 0u; x < file_count; ++x)
     {
-      studio::resources::file_info info{};
+      if (next_offset < chunk_offset || next_offset + entry_header_size > chunk_offset + chunk.size())
+      {
+        chunk.resize(chunk_size);
+        chunk_offset = next_offset;
 
-      info.compression_type = studio::resources::compression_type::none;
-      info.offset = std::size_t(raw_data.tellg());
+        raw_data.clear();
+        raw_data.seekg(chunk_offset, std::ios::beg);
+        raw_data.read(chunk.data(), chunk.size());
+        chunk.resize(std::size_t(raw_data.gcount()));
 
-      raw_data.read(reinterpret_cast<std::byte*>(child_filename.data()), child_filename.size() - 1);
+        if (chunk.size() < entry_header_size)
+        {
+          throw std::invalid_argument("DYN file has fewer entries than its header says.");
+        }
+      }
 
-      endian::little_uint32_t file_size{};
+      const auto* header = chunk.data() + (next_offset - chunk_offset);
+      const auto* name = reinterpret_cast<const char*>(header);
 
-      raw_data.read(reinterpret_cast<std::byte*>(&file_size), sizeof(file_size));
+      endian::little_uint32_t file_size{};
+      std::memcpy(&file_size, header + sizeof(std::array<std::byte, 13>), sizeof(file_size));
 
-      info.filename = child_filename.data();
+      studio::resources::file_info info{};
+      info.compression_type = studio::resources::compression_type::none;
+      info.offset = next_offset;
+      info.filename = std::string(name, std::find(name, name + 13, '\0'));
       info.size = file_size;
 
       results.emplace_back(info);
-      raw_data.seekg(file_size, std::ios::cur);
 
-      auto current_position = static_cast<int>(raw_data.tellg());
-
-      while ((current_position % 4) != 0)
-      {
-        current_position++;
-        raw_data.seekg(1, std::ios::cur);
-      }
+      const auto entry_end = next_offset + entry_header_size + file_size;
+      next_offset = (entry_end + 3) & ~std::size_t(3);
     }
 
     return results;
@@ -238,21 +339,29 @@ namespace studio::resources::vol::three_space
     endian::little_uint32_t header_size;
     raw_data.read(reinterpret_cast<std::byte*>(&header_size), sizeof(header_size));
 
+    // Each directory entry is a 13 character name, the index of its folder and the offset of the entry.
+    constexpr auto directory_entry_size = sizeof(std::array<std::byte, 13>) + sizeof(std::uint8_t) + sizeof(endian::little_uint32_t);
+
+    // Each entry then starts with a tag followed by its sizes.
+    constexpr auto entry_tag_size = sizeof(std::byte) + sizeof(std::array<endian::little_uint32_t, 2>);
+
+    std::vector<std::byte> directory(num_files * directory_entry_size);
+    raw_data.read(directory.data(), directory.size());
+    directory.resize(std::size_t(raw_data.gcount()));
+
     std::vector<studio::resources::file_info> files;
     files.reserve(num_files);
 
-    std::array<char, 14> filename{ '\0' };
-
-    for (auto i = 0u; i < num_files; ++i)
+    for (auto i = 0u; i < directory.size() / directory_entry_size; ++i)
     {
-      studio::resources::file_info info{};
-
-      raw_data.read(reinterpret_cast<std::byte*>(filename.data()), filename.size() - 1);
-      std::uint8_t folder_index;
-      raw_data.read(reinterpret_cast<std::byte*>(&folder_index), sizeof(folder_index));
+      const auto* raw_entry = directory.data() + i * directory_entry_size;
+      const auto* name = reinterpret_cast<const char*>(raw_entry);
+      const auto folder_index = std::to_integer<std::uint8_t>(raw_entry[13]);
 
       endian::little_uint32_t offset;
-      raw_data.read(reinterpret_cast<std::byte*>(&offset), sizeof(offset));
+      std::memcpy(&offset, raw_entry + 14, sizeof(offset));
+
+      studio::resources::file_info info{};
 
       if (folder_index > folders.size() || folders.empty())
       {
@@ -267,33 +376,83 @@ namespace studio::resources::vol::three_space
       {
         info.compression_type = studio::resources::compression_type::none;
         info.offset = offset;
-        info.filename = filename.data();
+        info.filename = std::string(name, std::find(name, name + 13, '\0'));
 
         files.emplace_back(info);
       }
     }
 
-    for (auto& file : files)
-    {
-      raw_data.seekg(file.offset, std::ios::beg);
+    // Entry headers are read in offset order, while the listing keeps the order of the directory.
+    std::vector<studio::resources::file_info*> by_offset(files.size());
+    std::transform(files.begin(), files.end(), by_offset.begin(), [](auto& file) { return &file; });
+
+    std::sort(by_offset.begin(), by_offset.end(), [](const auto* a, const auto* b) {
+      return a->offset < b->offset;
+    });
+
+    read_header_batches(
+      by_offset.begin(),
+      by_offset.end(),
+      entry_tag_size,
+      [](const auto* file) { return file->offset; },
+      [&](auto offset, auto* output, auto count) {
+        raw_data.clear();
+        raw_data.seekg(std::streamoff(offset), std::ios::beg);
+        raw_data.read(output, std::streamsize(count));
+        return std::size_t(raw_data.gcount());
+      },
+      [](auto* file, const std::byte* header) {
+        if (!header || !(header[0] == std::byte{ 0x02 } || header[0] == std::byte{ 0x09 }))
+        {
+          throw std::invalid_argument("VOL file has corrupted data.");
+        }
 
-      std::byte entry{};
-      raw_data.read(&entry, sizeof(entry));
+        file->compression_type = header[0] == std::byte{ 0x02 } ? compression_type::none : compression_type::lz;
 
-      if (!(entry == std::byte{ 0x02 } || entry == std::byte{ 0x09 }))
+        std::array<endian::little_uint32_t, 2> file_info{};
+        std::memcpy(&file_info, header + 1, sizeof(file_info));
+
+        // Compressed entries are taken to store their packed size first, followed by the expanded size.
+        // This layout is provisional: it matches the hand made entries in the tests, but hasn't been checked against a shipped volume.
+        file->size = file->compression_type == compression_type::none ? file_info[0] : file_info[1];
+      });
+
+    return files;
+  }
+
+  std::vector<checksum_entry> get_checksum_entries(std::basic_istream<std::byte>& stream, const std::filesystem::path& archive_path)
+  {
+    std::vector<checksum_entry> results;
+    std::vector<std::uint32_t> checksums;
+
+    auto add_entries = [&](std::vector<studio::resources::file_info> entries, const std::filesystem::path& volume_path) {
+      for (auto i = 0u; i < entries.size() && i < checksums.size(); ++i)
       {
-        throw std::invalid_argument("VOL file has corrupted data.");
+        const auto data_offset = entries[i].offset + entry_header_size;
+        results.push_back({ std::move(entries[i]), volume_path, data_offset, checksums[i] });
       }
 
-      file.compression_type = entry == std::byte{ 0x02 } ? compression_type::none : compression_type::lz;
+      checksums.clear();
+    };
 
-      std::array<endian::little_uint32_t, 2> file_info{};
-      raw_data.read(reinterpret_cast<std::byte*>(&file_info), sizeof(file_info));
+    if (dyn_file_archive::is_supported(stream))
+    {
+      add_entries(get_dyn_data(stream, &checksums), archive_path);
+      return results;
+    }
 
-      file.size = file_info[0];
+    if (!rmf_file_archive::is_supported(stream))
+    {
+      throw std::invalid_argument("File is neither an RMF nor a DYN file.");
     }
 
-    return files;
+    for (auto& volume : read_rmf_index(stream, archive_path).volumes)
+    {
+      checksums = std::move(volume.checksums);
+      add_entries(std::move(volume.entries), archive_path.parent_path() / volume.name);
+    }
+
+    return results;
   }
 
   bool rmf_file_archive::is_supported(std::basic_istream<std::byte>& stream)
@@ -323,6 +482,16 @@ namespace studio::resources::vol::three_space
     return is_supported(stream);
   }
 
+  std::vector<studio::resources::file_signature> rmf_file_archive::get_signatures()
+  {
+    return std::vector<studio::resources::file_signature>(rmf_tags.begin(), rmf_tags.end());
+  }
+
+  std::vector<studio::resources::file_signature> rmf_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
   std::vector<rmf_file_archive::content_info> rmf_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
   {
     std::vector<std::variant<studio::resources::folder_info, studio::resources::file_info>> results;
@@ -341,18 +510,46 @@ namespace studio::resources::vol::three_space
     }
     else
     {
-      auto raw_results = get_rmf_data(stream, archive_or_folder_path);
-
-      results.reserve(raw_results.size());
+      const auto index = get_index(stream, archive_or_folder_path.parent_path());
+      const auto volume_name = archive_or_folder_path.filename().string();
 
-      std::transform(raw_results.begin(), raw_results.end(), std::back_inserter(results), [&](auto& value) {
-        return value;
+      auto volume = std::find_if(index->volumes.begin(), index->volumes.end(), [&](const auto& other) {
+        return other.name == volume_name;
       });
+
+      if (volume != index->volumes.end())
+      {
+        results.reserve(volume->entries.size());
+        std::copy(volume->entries.begin(), volume->entries.end(), std::back_inserter(results));
+      }
     }
 
     return results;
   }
 
+  std::shared_ptr<const rmf_index> rmf_file_archive::get_index(std::basic_istream<std::byte>& stream, const std::filesystem::path& rmf_path) const
+  {
+    const auto key = rmf_path.u8string();
+
+    {
+      std::lock_guard<std::mutex> lock(index_mutex);
+      auto existing = indexes.find(key);
+
+      if (existing != indexes.end() && existing->second->is_current(rmf_path))
+      {
+        return existing->second;
+      }
+    }
+
+    // Reading happens without the lock, so other RMF files can be listed at the same time.
+    auto index = std::make_shared<const rmf_index>(read_rmf_index(stream, rmf_path));
+
+    std::lock_guard<std::mutex> lock(index_mutex);
+    indexes[key] = index;
+
+    return index;
+  }
+
   void rmf_file_archive::set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const
   {
     constexpr auto header_size = sizeof(std::array<std::byte, 13>) + sizeof(endian::little_int32_t);
@@ -367,18 +564,34 @@ namespace studio::resources::vol::three_space
     }
   }
 
-  void rmf_file_archive::extract_file_contents(std::basic_istream<std::byte>&, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const
+  std::filesystem::path rmf_file_archive::get_data_path(const std::filesystem::path&, const studio::resources::file_info& info) const
   {
-    auto main_path = info.folder_path.parent_path().parent_path();
-    auto resource_file = info.folder_path.filename();
+    return info.folder_path.parent_path().parent_path() / info.folder_path.filename();
+  }
 
-    auto real_stream = std::basic_ifstream<std::byte>(main_path / resource_file, std::ios::binary);
+  void rmf_file_archive::extract_file_contents(std::basic_istream<std::byte>&, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const
+  {
+    // The data is read from the volume next to the RMF file, rather than from the stream of the RMF file itself.
+    auto volume = std::make_shared<const studio::resources::shared_file>(get_data_path({}, info));
+    studio::resources::file_range_stream real_stream(volume, 0, volume->size());
 
     set_stream_position(real_stream, info);
 
-    std::copy_n(std::istreambuf_iterator<std::byte>(real_stream),
-                info.size,
-                std::ostreambuf_iterator<std::byte>(output));
+    std::array<std::byte, 65536> buffer{};
+
+    for (auto remaining = info.size; remaining > 0;)
+    {
+      real_stream.read(buffer.data(), std::streamsize(std::min(remaining, buffer.size())));
+      const auto count = std::size_t(real_stream.gcount());
+
+      if (count == 0)
+      {
+        throw std::invalid_argument("The entry " + info.filename.string() + " extends past the end of its volume.");
+      }
+
+      output.write(buffer.data(), std::streamsize(count));
+      remaining -= count;
+    }
   }
 
   bool dyn_file_archive::is_supported(std::basic_istream<std::byte>& stream)
@@ -397,6 +610,16 @@ namespace studio::resources::vol::three_space
     return is_supported(stream);
   }
 
+  std::vector<studio::resources::file_signature> dyn_file_archive::get_signatures()
+  {
+    return { dyn_tag };
+  }
+
+  std::vector<studio::resources::file_signature> dyn_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
   std::vector<dyn_file_archive::content_info> dyn_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
   {
     std::vector<dyn_file_archive::content_info> results;
@@ -416,13 +639,15 @@ namespace studio::resources::vol::three_space
 
   void dyn_file_archive::set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const
   {
-    if (int(stream.tellg()) == info.offset)
+    const auto position = std::size_t(stream.tellg());
+
+    if (position == info.offset)
     {
-      stream.seekg(sizeof(std::array<std::byte, 13>) + sizeof(endian::little_int32_t), std::ios::cur);
+      stream.seekg(entry_header_size, std::ios::cur);
     }
-    else if (int(stream.tellg()) != info.offset + sizeof(std::array<std::byte, 13>) + sizeof(endian::little_int32_t))
+    else if (position != info.offset + entry_header_size)
     {
-      stream.seekg(info.offset + sizeof(endian::little_int32_t), std::ios::beg);
+      stream.seekg(info.offset + entry_header_size, std::ios::beg);
     }
   }
 
@@ -450,6 +675,16 @@ namespace studio::resources::vol::three_space
     return is_supported(stream);
   }
 
+  std::vector<studio::resources::file_signature> vol_file_archive::get_signatures()
+  {
+    return { vol_tag };
+  }
+
+  std::vector<studio::resources::file_signature> vol_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
   std::vector<dyn_file_archive::content_info> vol_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
   {
     std::vector<dyn_file_archive::content_info> results;
@@ -508,6 +743,23 @@ namespace studio::resources::vol::three_space
     stream.seekg(0, std::ios::end);
     auto last_byte = static_cast<std::size_t>(stream.tellg());
 
+    if (info.compression_type != compression_type::none)
+    {
+      stream.seekg(info.offset + sizeof(std::byte), std::ios::beg);
+
+      std::array<endian::little_uint32_t, 2> file_info{};
+      stream.read(reinterpret_cast<std::byte*>(&file_info), sizeof(file_info));
+
+      const auto remaining_bytes = last_byte - info.offset - header_size;
+      std::vector<std::byte> packed(std::min<std::size_t>(file_info[0], remaining_bytes));
+      stream.read(packed.data(), packed.size());
+
+      // The same provisional layout as in the listing, with the packed size first.
+      auto unpacked = decompress_lz(packed, file_info[1]);
+      output.write(unpacked.data(), unpacked.size());
+      return;
+    }
+
     stream.seekg(current_position, std::ios::beg);
 
     set_stream_position(stream, info);
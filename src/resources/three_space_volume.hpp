@@ -1,30 +1,86 @@
 #ifndef DARKSTARDTSCONVERTER_THREE_SPACE_VOLUME_HPP
 #define DARKSTARDTSCONVERTER_THREE_SPACE_VOLUME_HPP
 
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <unordered_map>
 #include "archive_plugin.hpp"
 #include "endian_arithmetic.hpp"
+#include "file_stamp.hpp"
 
 namespace studio::resources::vol::three_space
 {
+  // An entry of an RMF volume or DYN file, along with the checksum kept for it in the index.
+  struct checksum_entry
+  {
+    studio::resources::file_info info;
+    std::filesystem::path volume_path;
+    std::size_t data_offset;
+    std::uint32_t checksum;
+  };
+
+  // Lists the entries of every volume an RMF file refers to, or of a DYN file.
+  std::vector<checksum_entry> get_checksum_entries(std::basic_istream<std::byte>& stream, const std::filesystem::path& archive_path);
+
+  // Everything an RMF file says about its volumes, along with the names and sizes read from the volumes themselves.
+  struct rmf_index
+  {
+    struct volume
+    {
+      std::string name;
+      std::optional<studio::resources::file_stamp> stamp;
+
+      // Sorted by offset.
+      std::vector<studio::resources::file_info> entries;
+      std::vector<std::uint32_t> checksums;
+    };
+
+    std::optional<studio::resources::file_stamp> stamp;
+    std::vector<volume> volumes;
+
+    // Whether the RMF file and all of its volumes are still the same as when the index was read.
+    bool is_current(const std::filesystem::path& rmf_path) const;
+  };
+
+  // Listing the entries of any volume of an RMF file reads all of them at once,
+  // and the result is kept until the RMF file or one of the volumes changes.
   struct rmf_file_archive : studio::resources::archive_plugin
   {
     static bool is_supported(std::basic_istream<std::byte>& stream);
 
+    static std::vector<studio::resources::file_signature> get_signatures();
+
     bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
 
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
+
     std::vector<std::variant<studio::resources::folder_info, studio::resources::file_info>> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
 
+    // Entries are kept in the volumes next to the RMF file, not in the RMF file itself.
+    std::filesystem::path get_data_path(const std::filesystem::path& archive_path, const studio::resources::file_info& info) const override;
+
     void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
 
     void extract_file_contents(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const override;
+
+  private:
+    std::shared_ptr<const rmf_index> get_index(std::basic_istream<std::byte>& stream, const std::filesystem::path& rmf_path) const;
+
+    mutable std::mutex index_mutex;
+    mutable std::unordered_map<std::string, std::shared_ptr<const rmf_index>> indexes;
   };
 
   struct dyn_file_archive : studio::resources::archive_plugin
   {
     static bool is_supported(std::basic_istream<std::byte>& stream);
 
+    static std::vector<studio::resources::file_signature> get_signatures();
+
     bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
 
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
+
     std::vector<std::variant<studio::resources::folder_info, studio::resources::file_info>> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
 
     void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
@@ -36,8 +92,12 @@ namespace studio::resources::vol::three_space
   {
     static bool is_supported(std::basic_istream<std::byte>& stream);
 
+    static std::vector<studio::resources::file_signature> get_signatures();
+
     bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
 
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
+
     std::vector<std::variant<studio::resources::folder_info, studio::resources::file_info>> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
 
     void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
@@ -65,6 +65,16 @@ namespace studio::resources::vol::trophy_bass
     return is_supported(stream);
   }
 
+  std::vector<studio::resources::file_signature> rbx_file_archive::get_signatures()
+  {
+    return { rbx_tag };
+  }
+
+  std::vector<studio::resources::file_signature> rbx_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
   std::vector<std::variant<folder_info, studio::resources::file_info>> rbx_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
   {
     std::vector<studio::resources::file_info> results;
@@ -175,6 +185,16 @@ namespace studio::resources::vol::trophy_bass
     return is_supported(stream);
   }
 
+  std::vector<studio::resources::file_signature> tbv_file_archive::get_signatures()
+  {
+    return { tbv_tag };
+  }
+
+  std::vector<studio::resources::file_signature> tbv_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
   std::vector<rbx_file_archive::content_info> tbv_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
   {
     std::vector<studio::resources::file_info> results;
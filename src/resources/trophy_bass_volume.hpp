@@ -10,8 +10,12 @@ namespace studio::resources::vol::trophy_bass
   {
     static bool is_supported(std::basic_istream<std::byte>& stream);
 
+    static std::vector<studio::resources::file_signature> get_signatures();
+
     bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
 
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
+
     std::vector<content_info> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
 
     void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
@@ -23,8 +27,12 @@ namespace studio::resources::vol::trophy_bass
   {
     static bool is_supported(std::basic_istream<std::byte>& stream);
 
+    static std::vector<studio::resources::file_signature> get_signatures();
+
     bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
 
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
+
     std::vector<content_info> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
 
     void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <functional>
+#include "resources/virtual_file_system.hpp"
+
+namespace studio::resources
+{
+  virtual_file_system::virtual_file_system(const studio::resources::resource_explorer& explorer, std::vector<std::filesystem::path> new_layers)
+    : layers(std::move(new_layers))
+  {
+    std::vector<std::vector<studio::resources::file_info>> layer_files;
+    layer_files.reserve(layers.size());
+
+    std::size_t total = 0;
+
+    for (const auto& layer : layers)
+    {
+      std::vector<studio::resources::file_info> files;
+
+      if (std::filesystem::is_directory(layer))
+      {
+        for (const auto& item : std::filesystem::recursive_directory_iterator(layer))
+        {
+          if (item.is_regular_file() && !explorer.get_archive_type(item.path()).has_value())
+          {
+            auto& info = files.emplace_back();
+            info.filename = item.path().filename();
+            info.folder_path = item.path().parent_path();
+            info.size = std::size_t(item.file_size());
+          }
+        }
+      }
+      else
+      {
+        files = explorer.find_files(layer, { "ALL" });
+      }
+
+      total += files.size();
+      layer_files.emplace_back(std::move(files));
+    }
+
+    entries.reserve(total);
+    known_names = studio::resources::bloom_filter(total);
+
+    for (auto& files : layer_files)
+    {
+      for (auto& info : files)
+      {
+        auto key = to_key(info.filename.string());
+        known_names.add(std::hash<std::string>{}(key));
+        entries.insert_or_assign(std::move(key), std::move(info));
+      }
+    }
+  }
+
+  std::vector<std::filesystem::path> virtual_file_system::get_default_layers(const studio::resources::resource_explorer& explorer, const std::vector<std::string_view>& archive_extensions)
+  {
+    std::vector<std::filesystem::path> results;
+
+    for (auto& archive : explorer.find_files(archive_extensions))
+    {
+      auto path = archive.folder_path / archive.filename;
+
+      // Archives nested in other archives are covered by the layer of the outer archive.
+      if (std::filesystem::is_directory(archive.folder_path) && explorer.get_archive_type(path).has_value())
+      {
+        results.emplace_back(std::move(path));
+      }
+    }
+
+    std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+      return to_key(a.generic_string()) < to_key(b.generic_string());
+    });
+
+    results.emplace_back(explorer.get_search_path());
+
+    return results;
+  }
+
+  const std::vector<std::filesystem::path>& virtual_file_system::get_layers() const
+  {
+    return layers;
+  }
+
+  std::optional<studio::resources::file_info> virtual_file_system::find_file(std::string_view name) const
+  {
+    const auto key = to_key(name);
+
+    if (!known_names.might_contain(std::hash<std::string>{}(key)))
+    {
+      return std::nullopt;
+    }
+
+    if (auto existing = entries.find(key); existing != entries.end())
+    {
+      return existing->second;
+    }
+
+    return std::nullopt;
+  }
+
+  bool virtual_file_system::might_contain(std::string_view name) const
+  {
+    return known_names.might_contain(std::hash<std::string>{}(to_key(name)));
+  }
+
+  std::size_t virtual_file_system::size() const
+  {
+    return entries.size();
+  }
+
+  std::string virtual_file_system::to_key(std::string_view name)
+  {
+    // File names in the games are plain ASCII, so there is no need to go through a locale.
+    std::string result(name);
+    std::transform(result.begin(), result.end(), result.begin(), [](char value) {
+      return value >= 'A' && value <= 'Z' ? char(value - 'A' + 'a') : value;
+    });
+    return result;
+  }
+}// namespace studio::resources
@@ -0,0 +1,45 @@
+#ifndef DARKSTARDTSCONVERTER_VIRTUAL_FILE_SYSTEM_HPP
+#define DARKSTARDTSCONVERTER_VIRTUAL_FILE_SYSTEM_HPP
+
+#include <vector>
+#include <string>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include "resource_explorer.hpp"
+#include "bloom_filter.hpp"
+
+namespace studio::resources
+{
+  // Resolves file names the way the games do: loose folders and volumes are stacked as layers,
+  // and a file in a later layer hides any file with the same name in an earlier one.
+  // Names are matched without regard to case or to the folder they are in.
+  class virtual_file_system
+  {
+  public:
+    // Layers go from the lowest to the highest precedence.
+    // A folder layer only provides the loose files in it, while an archive layer provides everything inside of it.
+    virtual_file_system(const studio::resources::resource_explorer& explorer, std::vector<std::filesystem::path> layers);
+
+    // Every archive in the search path in alphabetical order, followed by the loose files of the search path,
+    // which matches how the games let loose files override the contents of volumes.
+    static std::vector<std::filesystem::path> get_default_layers(const studio::resources::resource_explorer& explorer, const std::vector<std::string_view>& archive_extensions);
+
+    const std::vector<std::filesystem::path>& get_layers() const;
+
+    std::optional<studio::resources::file_info> find_file(std::string_view name) const;
+
+    bool might_contain(std::string_view name) const;
+
+    std::size_t size() const;
+
+  private:
+    static std::string to_key(std::string_view name);
+
+    std::vector<std::filesystem::path> layers;
+    std::unordered_map<std::string, studio::resources::file_info> entries;
+    studio::resources::bloom_filter known_names;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_VIRTUAL_FILE_SYSTEM_HPP
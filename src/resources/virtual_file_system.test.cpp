@@ -0,0 +1,35 @@
+#include <catch2/catch.hpp>
+#include "virtual_file_system.hpp"
+#include "three_space_volume.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+TEST_CASE("Later layers override earlier ones regardless of case", "[resources]")
+{
+  const auto folder = make_test_folder("virtual-file-system");
+  std::filesystem::create_directories(folder / "mod");
+
+  write_file(folder / "simple.vol", single_entry_volume);
+  write_file(folder / "mod" / "PLAIN.TXT", "modded");
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".vol", std::make_unique<studio::resources::vol::three_space::vol_file_archive>());
+
+  const auto layers = studio::resources::virtual_file_system::get_default_layers(explorer, { ".vol" });
+  REQUIRE(layers == std::vector<std::filesystem::path>{ folder / "simple.vol", folder });
+
+  studio::resources::virtual_file_system loose_last(explorer, layers);
+
+  auto result = loose_last.find_file("Plain.txt");
+  REQUIRE(result.has_value());
+  REQUIRE(result->folder_path == folder / "mod");
+
+  studio::resources::virtual_file_system volume_last(explorer, { folder, folder / "simple.vol" });
+
+  result = volume_last.find_file("plain.txt");
+  REQUIRE(result.has_value());
+  REQUIRE(result->folder_path == folder / "simple.vol");
+
+  REQUIRE_FALSE(volume_last.find_file("missing.dts").has_value());
+}
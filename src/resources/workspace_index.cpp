@@ -0,0 +1,439 @@
+#include <array>
+#include <atomic>
+#include <thread>
+#include <sstream>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <mutex>
+#include "resources/workspace_index.hpp"
+#include "endian_arithmetic.hpp"
+#include "shared.hpp"
+
+namespace studio::resources
+{
+  namespace endian = boost::endian;
+
+  constexpr auto index_tag = shared::to_tag<4>({ '3', 'S', 'I', 'X' });
+  constexpr std::uint32_t index_version = 4;
+
+  // Paths repeat between listings (every listing inside a volume refers to the same archive),
+  // so they are all written once to a string table and referred to by index.
+  class string_table
+  {
+  public:
+    std::uint32_t add(const std::string& value)
+    {
+      auto [existing, added] = indexes.emplace(value, std::uint32_t(values.size()));
+
+      if (added)
+      {
+        values.emplace_back(value);
+      }
+
+      return existing->second;
+    }
+
+    const std::vector<std::string>& get_values() const
+    {
+      return values;
+    }
+
+  private:
+    std::unordered_map<std::string, std::uint32_t> indexes;
+    std::vector<std::string> values;
+  };
+
+  class index_writer
+  {
+  public:
+    template<typename ValueType>
+    void write(ValueType value)
+    {
+      const auto* bytes = reinterpret_cast<const char*>(&value);
+      buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+    }
+
+    void write_string(std::string_view value)
+    {
+      write(endian::little_uint32_t(std::uint32_t(value.size())));
+      buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    const std::vector<char>& get_buffer() const
+    {
+      return buffer;
+    }
+
+  private:
+    std::vector<char> buffer;
+  };
+
+  class index_reader
+  {
+  public:
+    explicit index_reader(const std::vector<char>& buffer) : buffer(buffer)
+    {
+    }
+
+    template<typename ValueType>
+    ValueType read()
+    {
+      ValueType value{};
+      check(sizeof(value));
+      std::copy_n(buffer.data() + position, sizeof(value), reinterpret_cast<char*>(&value));
+      position += sizeof(value);
+      return value;
+    }
+
+    std::string read_string()
+    {
+      const std::size_t size = read<endian::little_uint32_t>();
+      check(size);
+      std::string result(buffer.data() + position, size);
+      position += size;
+      return result;
+    }
+
+  private:
+    void check(std::size_t size) const
+    {
+      if (position + size > buffer.size())
+      {
+        throw std::invalid_argument("The workspace index is truncated.");
+      }
+    }
+
+    const std::vector<char>& buffer;
+    std::size_t position = 0;
+  };
+
+  workspace_index::workspace_index(std::filesystem::path index_path) : index_path(std::move(index_path))
+  {
+  }
+
+  std::filesystem::path workspace_index::get_default_path(const std::filesystem::path& search_path)
+  {
+    const auto key = std::hash<std::string>{}(std::filesystem::absolute(search_path).u8string());
+
+    std::stringstream filename;
+    filename << std::hex << key << ".index";
+
+    return std::filesystem::temp_directory_path() / "3space-studio" / filename.str();
+  }
+
+  const workspace_index::listing* workspace_index::find_valid(const std::filesystem::path& listing_path, const std::filesystem::path& archive_path, const studio::resources::file_stamp& stamp) const
+  {
+    auto existing = listings.find(listing_path.u8string());
+
+    if (existing == listings.end() || existing->second.stamp != stamp || existing->second.archive_path != archive_path)
+    {
+      return nullptr;
+    }
+
+    for (const auto& data : existing->second.data_files)
+    {
+      if (get_file_stamp(data.path) != data.stamp)
+      {
+        return nullptr;
+      }
+    }
+
+    return &existing->second;
+  }
+
+  std::optional<std::vector<workspace_index::content_info>> workspace_index::find(const std::filesystem::path& listing_path, const std::filesystem::path& archive_path) const
+  {
+    const auto stamp = get_file_stamp(archive_path);
+
+    if (!stamp.has_value())
+    {
+      return std::nullopt;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    if (auto* existing = find_valid(listing_path, archive_path, stamp.value()); existing)
+    {
+      return existing->contents.get_listing();
+    }
+
+    return std::nullopt;
+  }
+
+  bool workspace_index::contains(const std::filesystem::path& listing_path, const std::filesystem::path& archive_path) const
+  {
+    const auto stamp = get_file_stamp(archive_path);
+
+    if (!stamp.has_value())
+    {
+      return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+
+    return find_valid(listing_path, archive_path, stamp.value()) != nullptr;
+  }
+
+  void workspace_index::store(const std::filesystem::path& listing_path,
+    const std::filesystem::path& archive_path,
+    const std::vector<content_info>& contents,
+    const std::vector<std::filesystem::path>& data_paths)
+  {
+    const auto stamp = get_file_stamp(archive_path);
+
+    if (!stamp.has_value())
+    {
+      return;
+    }
+
+    std::vector<data_file> data_files;
+    data_files.reserve(data_paths.size());
+
+    for (const auto& data_path : data_paths)
+    {
+      const auto data_stamp = get_file_stamp(data_path);
+
+      // A listing of data which can't be found can't be checked later either.
+      if (!data_stamp.has_value())
+      {
+        return;
+      }
+
+      data_files.push_back({ data_path, data_stamp.value() });
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    listings.insert_or_assign(listing_path.u8string(), listing{ archive_path, stamp.value(), std::move(data_files), studio::resources::archive_index(contents) });
+    generation++;
+  }
+
+  void workspace_index::load()
+  {
+    std::vector<char> buffer;
+
+    {
+      std::ifstream file(index_path, std::ios::binary);
+
+      if (!file)
+      {
+        return;
+      }
+
+      buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::lock_guard<std::mutex> save_lock(save_mutex);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    try
+    {
+      index_reader reader(buffer);
+
+      if (reader.read<std::array<std::byte, 4>>() != index_tag || reader.read<endian::little_uint32_t>() != index_version || reader.read<endian::little_uint32_t>() != listing_version)
+      {
+        return;
+      }
+
+      std::vector<std::string> strings(reader.read<endian::little_uint32_t>());
+
+      for (auto& value : strings)
+      {
+        value = reader.read_string();
+      }
+
+      auto get_string = [&](std::uint32_t index) -> const std::string& {
+        if (index >= strings.size())
+        {
+          throw std::invalid_argument("The workspace index refers to a missing string.");
+        }
+
+        return strings[index];
+      };
+
+      auto get_path = [&](std::uint32_t index) {
+        return std::filesystem::u8path(get_string(index));
+      };
+
+      const std::uint32_t listing_count = reader.read<endian::little_uint32_t>();
+
+      for (auto i = 0u; i < listing_count; ++i)
+      {
+        const auto& key = get_string(reader.read<endian::little_uint32_t>());
+
+        listing value{};
+        value.archive_path = get_path(reader.read<endian::little_uint32_t>());
+        value.stamp.size = reader.read<endian::little_uint64_t>();
+        value.stamp.write_time = reader.read<endian::little_int64_t>();
+
+        value.data_files.resize(reader.read<endian::little_uint32_t>());
+
+        for (auto& data : value.data_files)
+        {
+          data.path = get_path(reader.read<endian::little_uint32_t>());
+          data.stamp.size = reader.read<endian::little_uint64_t>();
+          data.stamp.write_time = reader.read<endian::little_int64_t>();
+        }
+
+        const std::uint32_t path_count = reader.read<endian::little_uint32_t>();
+
+        for (auto j = 0u; j < path_count; ++j)
+        {
+          value.contents.add_path(get_path(reader.read<endian::little_uint32_t>()));
+        }
+
+        const std::uint32_t entry_count = reader.read<endian::little_uint32_t>();
+        value.contents.reserve(entry_count);
+
+        for (auto j = 0u; j < entry_count; ++j)
+        {
+          const auto kind = archive_index::entry_kind(reader.read<std::uint8_t>());
+          const auto name = reader.read_string();
+          const std::uint32_t path_id = reader.read<endian::little_uint32_t>();
+
+          if (kind == archive_index::entry_kind::file)
+          {
+            const std::uint64_t offset = reader.read<endian::little_uint64_t>();
+            const std::uint64_t size = reader.read<endian::little_uint64_t>();
+            value.contents.add_file(name, path_id, offset, size, studio::resources::compression_type(reader.read<std::uint8_t>()));
+          }
+          else if (kind == archive_index::entry_kind::counted_folder)
+          {
+            value.contents.add_folder(name, path_id, reader.read<endian::little_uint64_t>());
+          }
+          else
+          {
+            value.contents.add_folder(name, path_id, std::nullopt);
+          }
+        }
+
+        listings.insert_or_assign(key, std::move(value));
+      }
+
+      saved_generation = generation;
+    }
+    catch (const std::invalid_argument&)
+    {
+      // A damaged index is the same as not having one.
+      listings.clear();
+    }
+  }
+
+  void workspace_index::save() const
+  {
+    std::lock_guard<std::mutex> save_lock(save_mutex);
+
+    string_table strings;
+    index_writer body;
+    std::uint64_t body_generation = 0;
+
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex);
+
+      if (generation == saved_generation)
+      {
+        return;
+      }
+
+      body_generation = generation;
+
+      body.write(endian::little_uint32_t(std::uint32_t(listings.size())));
+
+      for (const auto& [key, value] : listings)
+      {
+        body.write(endian::little_uint32_t(strings.add(key)));
+        body.write(endian::little_uint32_t(strings.add(value.archive_path.u8string())));
+        body.write(endian::little_uint64_t(value.stamp.size));
+        body.write(endian::little_int64_t(value.stamp.write_time));
+
+        body.write(endian::little_uint32_t(std::uint32_t(value.data_files.size())));
+
+        for (const auto& data : value.data_files)
+        {
+          body.write(endian::little_uint32_t(strings.add(data.path.u8string())));
+          body.write(endian::little_uint64_t(data.stamp.size));
+          body.write(endian::little_int64_t(data.stamp.write_time));
+        }
+
+        const auto& contents = value.contents;
+
+        body.write(endian::little_uint32_t(std::uint32_t(contents.get_paths().size())));
+
+        for (const auto& path : contents.get_paths())
+        {
+          body.write(endian::little_uint32_t(strings.add(path.u8string())));
+        }
+
+        body.write(endian::little_uint32_t(std::uint32_t(contents.size())));
+
+        for (auto i = 0u; i < contents.size(); ++i)
+        {
+          const auto kind = contents.get_kind(i);
+
+          body.write(kind);
+          body.write_string(contents.get_name(i));
+          body.write(endian::little_uint32_t(contents.get_path_id(i)));
+
+          if (kind == archive_index::entry_kind::file)
+          {
+            body.write(endian::little_uint64_t(contents.get_offset(i)));
+            body.write(endian::little_uint64_t(contents.get_size(i)));
+            body.write(std::uint8_t(contents.get_compression_type(i)));
+          }
+          else if (kind == archive_index::entry_kind::counted_folder)
+          {
+            body.write(endian::little_uint64_t(contents.get_size(i)));
+          }
+        }
+      }
+    }
+
+    index_writer header;
+    header.write(index_tag);
+    header.write(endian::little_uint32_t(index_version));
+    header.write(endian::little_uint32_t(listing_version));
+    header.write(endian::little_uint32_t(std::uint32_t(strings.get_values().size())));
+
+    for (const auto& value : strings.get_values())
+    {
+      header.write_string(value);
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(index_path.parent_path(), error);
+
+    // Written next to the real index first, so that a reader never sees a partially written file.
+    // Other programs can be saving an index for the same search path, so every save gets a file of its own.
+    static std::atomic<std::uint64_t> save_count = 0;
+
+    std::stringstream temp_name;
+    temp_name << '.' << std::hex << std::hash<std::thread::id>{}(std::this_thread::get_id()) << '.' << save_count++ << ".tmp";
+
+    auto temp_path = index_path;
+    temp_path += temp_name.str();
+
+    auto written = false;
+
+    {
+      std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+      file.write(header.get_buffer().data(), std::streamsize(header.get_buffer().size()));
+      file.write(body.get_buffer().data(), std::streamsize(body.get_buffer().size()));
+      file.close();
+      written = bool(file);
+    }
+
+    if (written)
+    {
+      std::filesystem::rename(temp_path, index_path, error);
+    }
+
+    if (!written || error)
+    {
+      std::filesystem::remove(temp_path, error);
+      return;
+    }
+
+    saved_generation = body_generation;
+  }
+}// namespace studio::resources
@@ -0,0 +1,79 @@
+#ifndef DARKSTARDTSCONVERTER_WORKSPACE_INDEX_HPP
+#define DARKSTARDTSCONVERTER_WORKSPACE_INDEX_HPP
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <filesystem>
+#include "archive_plugin.hpp"
+#include "file_stamp.hpp"
+#include "archive_index.hpp"
+
+namespace studio::resources
+{
+  // Keeps the listings of archives on disk between runs.
+  // Every listing is stored with the size and modification time of the archive it came from, and of any other files
+  // its entries are kept in, so that only archives which have changed since need to be parsed again.
+  class workspace_index
+  {
+  public:
+    using content_info = studio::resources::archive_plugin::content_info;
+
+    // Stored in the header of every index. Bump it whenever a plugin lists the same archive differently,
+    // so that indexes written before the change are read again instead of returning the old listings.
+    constexpr static std::uint32_t listing_version = 1;
+
+    explicit workspace_index(std::filesystem::path index_path);
+
+    static std::filesystem::path get_default_path(const std::filesystem::path& search_path);
+
+    std::optional<std::vector<content_info>> find(const std::filesystem::path& listing_path, const std::filesystem::path& archive_path) const;
+
+    bool contains(const std::filesystem::path& listing_path, const std::filesystem::path& archive_path) const;
+
+    // "data_paths" are the files other than the archive which the entries of the listing are kept in, such as the volumes of an RMF file.
+    void store(const std::filesystem::path& listing_path,
+      const std::filesystem::path& archive_path,
+      const std::vector<content_info>& contents,
+      const std::vector<std::filesystem::path>& data_paths = {});
+
+    void load();
+
+    // Safe to call from several threads at once. Saves which fail are tried again by the next call.
+    void save() const;
+
+  private:
+    struct data_file
+    {
+      std::filesystem::path path;
+      studio::resources::file_stamp stamp;
+    };
+
+    struct listing
+    {
+      std::filesystem::path archive_path;
+      studio::resources::file_stamp stamp;
+      std::vector<data_file> data_files;
+      studio::resources::archive_index contents;
+    };
+
+    const listing* find_valid(const std::filesystem::path& listing_path, const std::filesystem::path& archive_path, const studio::resources::file_stamp& stamp) const;
+
+    std::filesystem::path index_path;
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, listing> listings;
+
+    // Counts changes to the listings, so that a save only has to happen when it is behind.
+    std::uint64_t generation = 0;
+
+    // Only one save writes the index at a time, and it alone keeps track of what has been saved.
+    mutable std::mutex save_mutex;
+    mutable std::uint64_t saved_generation = 0;
+  };
+}// namespace studio::resources
+
+#endif//DARKSTARDTSCONVERTER_WORKSPACE_INDEX_HPP
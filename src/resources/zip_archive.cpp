@@ -0,0 +1,453 @@
+#include <array>
+#include <limits>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <algorithm>
+#include "resources/zip_archive.hpp"
+#include "resources/resource_explorer.hpp"
+#include "resources/bounded_reader.hpp"
+#include "resources/inflate.hpp"
+#include "resources/crc32.hpp"
+
+namespace studio::resources::zip
+{
+  namespace
+  {
+    constexpr std::uint32_t local_header_tag = 0x04034b50;
+    constexpr std::uint32_t central_header_tag = 0x02014b50;
+    constexpr std::uint32_t end_of_directory_tag = 0x06054b50;
+    constexpr std::uint32_t zip64_locator_tag = 0x07064b50;
+    constexpr std::uint32_t zip64_end_of_directory_tag = 0x06064b50;
+
+    constexpr std::size_t local_header_size = 30;
+    constexpr std::size_t central_header_size = 46;
+    constexpr std::size_t end_of_directory_size = 22;
+    constexpr std::size_t zip64_locator_size = 20;
+    constexpr std::size_t zip64_end_of_directory_size = 56;
+    constexpr std::size_t max_comment_size = 0xffff;
+
+    // A deflate match copies at most 258 bytes and takes at least 2 bits, and every block adds a few bits on top of that.
+    constexpr std::size_t max_deflate_ratio = 1032;
+
+    constexpr std::uint16_t zip64_extra_field = 0x0001;
+    constexpr std::uint16_t encrypted_flag = 0x0001;
+
+    constexpr std::uint16_t stored_method = 0;
+    constexpr std::uint16_t deflated_method = 8;
+
+    constexpr std::array<std::byte, 4> local_header_signature{ std::byte{ 'P' }, std::byte{ 'K' }, std::byte{ 3 }, std::byte{ 4 } };
+    constexpr std::array<std::byte, 4> empty_archive_signature{ std::byte{ 'P' }, std::byte{ 'K' }, std::byte{ 5 }, std::byte{ 6 } };
+
+    template<typename Value>
+    Value read_value(const std::byte* data)
+    {
+      Value result = 0;
+
+      for (auto i = 0u; i < sizeof(Value); ++i)
+      {
+        result |= Value(std::to_integer<std::uint8_t>(data[i])) << (i * 8);
+      }
+
+      return result;
+    }
+
+    std::vector<std::byte> read_range(std::basic_istream<std::byte>& stream, std::uint64_t offset, std::size_t size)
+    {
+      std::vector<std::byte> result(size);
+
+      stream.clear();
+      stream.seekg(std::streamoff(offset), std::ios::beg);
+      stream.read(result.data(), std::streamsize(size));
+
+      if (std::size_t(stream.gcount()) != size)
+      {
+        throw std::invalid_argument("The zip file ends before its central directory does.");
+      }
+
+      return result;
+    }
+
+    // Archives made on Windows sometimes use backslashes, and names which could escape the archive are not listed.
+    std::optional<std::string> normalise_name(std::string name)
+    {
+      std::replace(name.begin(), name.end(), '\\', '/');
+
+      name.erase(0, name.find_first_not_of('/'));
+
+      std::string_view remaining = name;
+
+      while (!remaining.empty())
+      {
+        const auto separator = remaining.find('/');
+
+        if (remaining.substr(0, separator) == "..")
+        {
+          return std::nullopt;
+        }
+
+        remaining = separator == std::string_view::npos ? std::string_view{} : remaining.substr(separator + 1);
+      }
+
+      return name;
+    }
+
+    zip_index::folder& add_folder(zip_index& index, const std::string& path)
+    {
+      if (auto existing = index.folders.find(path); existing != index.folders.end())
+      {
+        return existing->second;
+      }
+
+      auto& result = index.folders[path];
+
+      if (!path.empty())
+      {
+        const auto separator = path.rfind('/');
+        const auto parent = separator == std::string::npos ? std::string{} : path.substr(0, separator);
+
+        add_folder(index, parent).folders.emplace_back(path.substr(separator + 1));
+      }
+
+      return result;
+    }
+  }// namespace
+
+  zip_index read_zip_index(std::basic_istream<std::byte>& stream)
+  {
+    stream.clear();
+    stream.seekg(0, std::ios::end);
+    const auto file_size = std::uint64_t(stream.tellg());
+
+    if (file_size < end_of_directory_size)
+    {
+      throw std::invalid_argument("The file is too small to be a zip file.");
+    }
+
+    // The end of central directory record is followed by a comment of up to 64KB, so all of that is read at once and searched backwards.
+    const auto tail_size = std::size_t(std::min<std::uint64_t>(file_size, end_of_directory_size + max_comment_size + zip64_locator_size));
+    const auto tail = read_range(stream, file_size - tail_size, tail_size);
+
+    std::optional<std::size_t> record_position;
+
+    for (auto position = tail_size - end_of_directory_size + 1; position > 0; --position)
+    {
+      const auto* record = tail.data() + position - 1;
+
+      if (read_value<std::uint32_t>(record) == end_of_directory_tag && position - 1 + end_of_directory_size + read_value<std::uint16_t>(record + 20) <= tail_size)
+      {
+        record_position = position - 1;
+        break;
+      }
+    }
+
+    if (!record_position.has_value())
+    {
+      throw std::invalid_argument("The zip file has no end of central directory record.");
+    }
+
+    const auto* record = tail.data() + record_position.value();
+    std::uint64_t entry_count = read_value<std::uint16_t>(record + 10);
+    std::uint64_t directory_size = read_value<std::uint32_t>(record + 12);
+    std::uint64_t directory_offset = read_value<std::uint32_t>(record + 16);
+
+    if (record_position.value() >= zip64_locator_size && read_value<std::uint32_t>(record - zip64_locator_size) == zip64_locator_tag)
+    {
+      const auto zip64_offset = read_value<std::uint64_t>(record - zip64_locator_size + 8);
+      const auto zip64_record = read_range(stream, zip64_offset, zip64_end_of_directory_size);
+
+      if (read_value<std::uint32_t>(zip64_record.data()) != zip64_end_of_directory_tag)
+      {
+        throw std::invalid_argument("The zip file has an invalid zip64 end of central directory record.");
+      }
+
+      entry_count = read_value<std::uint64_t>(zip64_record.data() + 32);
+      directory_size = read_value<std::uint64_t>(zip64_record.data() + 40);
+      directory_offset = read_value<std::uint64_t>(zip64_record.data() + 48);
+    }
+
+    if (directory_offset > file_size || directory_size > file_size - directory_offset)
+    {
+      throw std::invalid_argument("The zip file has a central directory outside of the file.");
+    }
+
+    const auto directory = read_range(stream, directory_offset, std::size_t(directory_size));
+
+    zip_index index{};
+    add_folder(index, {});
+
+    std::size_t position = 0;
+
+    for (auto i = 0u; i < entry_count; ++i)
+    {
+      if (position + central_header_size > directory.size() || read_value<std::uint32_t>(directory.data() + position) != central_header_tag)
+      {
+        throw std::invalid_argument("The zip file has an invalid central directory entry.");
+      }
+
+      const auto* header = directory.data() + position;
+      const auto flags = read_value<std::uint16_t>(header + 8);
+      const auto method = read_value<std::uint16_t>(header + 10);
+      const auto crc = read_value<std::uint32_t>(header + 16);
+      std::uint64_t compressed_size = read_value<std::uint32_t>(header + 20);
+      std::uint64_t size = read_value<std::uint32_t>(header + 24);
+      const std::size_t name_size = read_value<std::uint16_t>(header + 28);
+      const std::size_t extra_size = read_value<std::uint16_t>(header + 30);
+      const std::size_t comment_size = read_value<std::uint16_t>(header + 32);
+      std::uint64_t local_offset = read_value<std::uint32_t>(header + 42);
+
+      const auto entry_size = central_header_size + name_size + extra_size + comment_size;
+
+      if (position + entry_size > directory.size())
+      {
+        throw std::invalid_argument("The zip file has an invalid central directory entry.");
+      }
+
+      const auto* name_data = reinterpret_cast<const char*>(header + central_header_size);
+      const auto* extra = header + central_header_size + name_size;
+      position += entry_size;
+
+      // Sizes and offsets too large for the regular fields are kept in the zip64 extra field, in a fixed order.
+      for (std::size_t extra_position = 0; extra_position + 4 <= extra_size;)
+      {
+        const auto field_id = read_value<std::uint16_t>(extra + extra_position);
+        const std::size_t field_size = read_value<std::uint16_t>(extra + extra_position + 2);
+        extra_position += 4;
+
+        if (field_id == zip64_extra_field)
+        {
+          auto field_position = extra_position;
+
+          for (auto* value : { &size, &compressed_size, &local_offset })
+          {
+            if (*value == std::numeric_limits<std::uint32_t>::max() && field_position + 8 <= extra_position + field_size && field_position + 8 <= extra_size)
+            {
+              *value = read_value<std::uint64_t>(extra + field_position);
+              field_position += 8;
+            }
+          }
+        }
+
+        extra_position += field_size;
+      }
+
+      auto name = normalise_name(std::string(name_data, name_size));
+
+      if (!name.has_value() || name->empty())
+      {
+        continue;
+      }
+
+      if (name->back() == '/')
+      {
+        name->pop_back();
+        add_folder(index, name.value());
+        continue;
+      }
+
+      if ((flags & encrypted_flag) || (method != stored_method && method != deflated_method) || local_offset >= file_size)
+      {
+        continue;
+      }
+
+      const auto separator = name->rfind('/');
+
+      studio::resources::file_info info{};
+      info.filename = separator == std::string::npos ? name.value() : name->substr(separator + 1);
+      info.offset = std::size_t(local_offset);
+      info.size = std::size_t(size);
+      info.compression_type = method == deflated_method ? studio::resources::compression_type::deflate : studio::resources::compression_type::none;
+
+      index.entries.insert_or_assign(local_offset, zip_index::entry{ compressed_size, crc });
+
+      add_folder(index, separator == std::string::npos ? std::string{} : name->substr(0, separator)).files.emplace_back(std::move(info));
+    }
+
+    return index;
+  }
+
+  bool zip_file_archive::is_supported(std::basic_istream<std::byte>& stream)
+  {
+    std::array<std::byte, 4> tag{};
+    stream.read(tag.data(), sizeof(tag));
+
+    stream.seekg(-int(sizeof(tag)), std::ios::cur);
+
+    return tag == local_header_signature || tag == empty_archive_signature;
+  }
+
+  bool zip_file_archive::stream_is_supported(std::basic_istream<std::byte>& stream) const
+  {
+    return is_supported(stream);
+  }
+
+  std::vector<studio::resources::file_signature> zip_file_archive::get_signatures()
+  {
+    return { local_header_signature, empty_archive_signature };
+  }
+
+  std::vector<studio::resources::file_signature> zip_file_archive::stream_signatures() const
+  {
+    return get_signatures();
+  }
+
+  std::vector<zip_file_archive::content_info> zip_file_archive::get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const
+  {
+    std::vector<content_info> results;
+
+    const auto archive_path = studio::resources::resource_explorer::get_archive_path(archive_or_folder_path);
+
+    auto folder_path = archive_or_folder_path.lexically_relative(archive_path).generic_string();
+
+    if (folder_path == ".")
+    {
+      folder_path.clear();
+    }
+
+    const auto index = get_index(stream, archive_path);
+    const auto folder = index->folders.find(folder_path);
+
+    if (folder == index->folders.end())
+    {
+      return results;
+    }
+
+    results.reserve(folder->second.folders.size() + folder->second.files.size());
+
+    for (const auto& name : folder->second.folders)
+    {
+      studio::resources::folder_info info{};
+      info.name = name;
+      info.full_path = archive_or_folder_path / name;
+      results.emplace_back(std::move(info));
+    }
+
+    for (auto info : folder->second.files)
+    {
+      info.folder_path = archive_or_folder_path;
+      results.emplace_back(std::move(info));
+    }
+
+    return results;
+  }
+
+  std::shared_ptr<const zip_index> zip_file_archive::get_index(std::basic_istream<std::byte>& stream, const std::filesystem::path& archive_path) const
+  {
+    const auto key = archive_path.u8string();
+    const auto stamp = studio::resources::get_file_stamp(archive_path);
+
+    {
+      std::lock_guard<std::mutex> lock(index_mutex);
+      auto existing = indexes.find(key);
+
+      if (existing != indexes.end() && existing->second->stamp == stamp)
+      {
+        return existing->second;
+      }
+    }
+
+    auto new_index = read_zip_index(stream);
+    new_index.stamp = stamp;
+
+    auto index = std::make_shared<const zip_index>(std::move(new_index));
+
+    std::lock_guard<std::mutex> lock(index_mutex);
+    indexes[key] = index;
+
+    return index;
+  }
+
+  void zip_file_archive::set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const
+  {
+    // The local header can have a different extra field than the central directory, so its own sizes have to be used.
+    std::array<std::byte, local_header_size> header{};
+
+    stream.clear();
+    stream.seekg(std::streamoff(info.offset), std::ios::beg);
+    stream.read(header.data(), std::streamsize(header.size()));
+
+    if (std::size_t(stream.gcount()) != header.size() || read_value<std::uint32_t>(header.data()) != local_header_tag)
+    {
+      throw std::invalid_argument("The zip file has an invalid local file header.");
+    }
+
+    const std::size_t name_size = read_value<std::uint16_t>(header.data() + 26);
+    const std::size_t extra_size = read_value<std::uint16_t>(header.data() + 28);
+
+    stream.seekg(std::streamoff(name_size + extra_size), std::ios::cur);
+  }
+
+  void zip_file_archive::extract_file_contents(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const
+  {
+    const auto index = get_index(stream, studio::resources::resource_explorer::get_archive_path(info.folder_path));
+    const auto entry = index->entries.find(info.offset);
+
+    if (entry == index->entries.end())
+    {
+      throw std::invalid_argument("The zip file has no entry for " + info.filename.string() + ".");
+    }
+
+    set_stream_position(stream, info);
+
+    const auto compressed_size = std::size_t(std::min<std::uint64_t>(entry->second.compressed_size, std::numeric_limits<std::size_t>::max()));
+
+    if (info.compression_type == studio::resources::compression_type::deflate)
+    {
+      // The listed size comes from the central directory, so sizes which no deflate data of this length could reach are rejected up front.
+      if (info.size / max_deflate_ratio > compressed_size)
+      {
+        throw std::invalid_argument("The zip file has a deflated entry which is larger than its compressed data allows.");
+      }
+
+      studio::resources::bounded_reader reader(stream, compressed_size);
+      std::uint32_t crc = 0;
+
+      const auto produced = studio::resources::inflate(reader, info.size, [&](const std::byte* data, std::size_t size) {
+        crc = studio::resources::crc32(nonstd::span<const std::byte>(data, size), crc);
+        output.write(data, std::streamsize(size));
+      });
+
+      if (produced != info.size)
+      {
+        throw std::invalid_argument("The zip file has a deflated entry which is smaller than its listed size.");
+      }
+
+      if (crc != entry->second.crc32)
+      {
+        throw std::invalid_argument("The zip file has a deflated entry which doesn't match its CRC.");
+      }
+
+      return;
+    }
+
+    if (compressed_size < info.size)
+    {
+      throw std::invalid_argument("The zip file has a stored entry which is smaller than its listed size.");
+    }
+
+    std::array<std::byte, 65536> buffer{};
+    std::uint32_t crc = 0;
+
+    for (auto remaining = info.size; remaining > 0;)
+    {
+      stream.read(buffer.data(), std::streamsize(std::min(remaining, buffer.size())));
+      const auto count = std::size_t(stream.gcount());
+
+      if (count == 0)
+      {
+        throw std::invalid_argument("The zip file has a stored entry which is smaller than its listed size.");
+      }
+
+      crc = studio::resources::crc32(nonstd::span<const std::byte>(buffer.data(), count), crc);
+      output.write(buffer.data(), std::streamsize(count));
+      remaining -= count;
+    }
+
+    if (crc != entry->second.crc32)
+    {
+      throw std::invalid_argument("The zip file has a stored entry which doesn't match its CRC.");
+    }
+  }
+}// namespace studio::resources::zip
@@ -0,0 +1,72 @@
+#ifndef DARKSTARDTSCONVERTER_ZIP_ARCHIVE_HPP
+#define DARKSTARDTSCONVERTER_ZIP_ARCHIVE_HPP
+
+#include <mutex>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <optional>
+#include <unordered_map>
+#include "archive_plugin.hpp"
+#include "file_stamp.hpp"
+
+namespace studio::resources::zip
+{
+  // Everything the central directory of a zip file says about its entries, grouped by the folder they are in.
+  struct zip_index
+  {
+    struct folder
+    {
+      std::vector<std::string> folders;
+
+      // The folder path of each entry is left empty, since it depends on where the archive is.
+      std::vector<studio::resources::file_info> files;
+    };
+
+    // What is needed to check the data of an entry, which file_info has no place for.
+    struct entry
+    {
+      std::uint64_t compressed_size;
+      std::uint32_t crc32;
+    };
+
+    std::optional<studio::resources::file_stamp> stamp;
+
+    // Keyed by the offset of the local header of each entry.
+    std::unordered_map<std::uint64_t, entry> entries;
+
+    // Keyed by the path of each folder relative to the root of the archive, using forward slashes.
+    std::unordered_map<std::string, folder> folders;
+  };
+
+  // Reads the end of central directory record and the central directory, with one read each.
+  // Entries which are encrypted or use anything other than stored or deflated data are left out.
+  zip_index read_zip_index(std::basic_istream<std::byte>& stream);
+
+  // Zip files as used by Torque and other later games. The folders inside of an archive are listed as folders of their own,
+  // and the central directory is only read once until the archive changes.
+  struct zip_file_archive : studio::resources::archive_plugin
+  {
+    static bool is_supported(std::basic_istream<std::byte>& stream);
+
+    static std::vector<studio::resources::file_signature> get_signatures();
+
+    bool stream_is_supported(std::basic_istream<std::byte>& stream) const override;
+
+    std::vector<studio::resources::file_signature> stream_signatures() const override;
+
+    std::vector<content_info> get_content_listing(std::basic_istream<std::byte>& stream, std::filesystem::path archive_or_folder_path) const override;
+
+    void set_stream_position(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info) const override;
+
+    void extract_file_contents(std::basic_istream<std::byte>& stream, const studio::resources::file_info& info, std::basic_ostream<std::byte>& output) const override;
+
+  private:
+    std::shared_ptr<const zip_index> get_index(std::basic_istream<std::byte>& stream, const std::filesystem::path& archive_path) const;
+
+    mutable std::mutex index_mutex;
+    mutable std::unordered_map<std::string, std::shared_ptr<const zip_index>> indexes;
+  };
+}// namespace studio::resources::zip
+
+#endif//DARKSTARDTSCONVERTER_ZIP_ARCHIVE_HPP
@@ -0,0 +1,254 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+#include "zip_archive.hpp"
+#include "inflate.hpp"
+#include "memory_stream.hpp"
+#include "mapped_file.hpp"
+#include "resource_explorer.hpp"
+#include "test_fixtures.hpp"
+
+using namespace studio::resources::test;
+
+namespace
+{
+  constexpr std::string_view readme_line = "A volume holds the shapes, bitmaps and palettes of a game. Entries can be stored, or compressed to save space on the disc.\n";
+
+  // The line above three times, as a single deflate block with dynamic Huffman codes.
+  constexpr std::uint8_t readme_deflated[] = {
+    0xe5, 0x8d, 0xc1, 0x0d, 0xc3, 0x30, 0x0c, 0xc4, 0xfe, 0x9d, 0xe2, 0x06, 0x08, 0xb2, 0x43, 0x1e,
+    0x19, 0x44, 0xb1, 0xae, 0xb5, 0x01, 0xdb, 0x32, 0x2c, 0x35, 0xf3, 0xd7, 0xc8, 0x1a, 0xfd, 0x92,
+    0x20, 0x78, 0xe0, 0xb6, 0xfa, 0x6d, 0x44, 0xb6, 0xaa, 0x8e, 0xc8, 0x84, 0x67, 0x19, 0xf4, 0x0d,
+    0x57, 0x89, 0x26, 0xc3, 0x21, 0x5d, 0x31, 0xa4, 0x32, 0x82, 0x0e, 0x7b, 0x43, 0xf0, 0x91, 0xc6,
+    0x1d, 0x67, 0x8f, 0x59, 0x16, 0x4a, 0xd2, 0x71, 0xad, 0x2c, 0x6c, 0x52, 0x37, 0xd8, 0x44, 0xb2,
+    0x36, 0x26, 0xdd, 0xa9, 0x08, 0x83, 0xcb, 0xbd, 0xec, 0x90, 0x44, 0x58, 0x7f, 0x0e, 0x5a, 0x3c,
+    0xed, 0xaf, 0xe3, 0x2f, 0xd7, 0x3f
+  };
+
+  // "abc" as a single deflate block with the fixed Huffman codes.
+  constexpr std::uint8_t abc_deflated[] = { 0x4b, 0x4c, 0x4a, 0x06, 0x00 };
+
+  template<std::size_t Size>
+  std::vector<std::byte> to_bytes(const std::uint8_t (&values)[Size])
+  {
+    return std::vector<std::byte>(reinterpret_cast<const std::byte*>(values), reinterpret_cast<const std::byte*>(values) + Size);
+  }
+
+  std::uint32_t crc_of(std::string_view values)
+  {
+    return studio::resources::crc32(nonstd::span<const std::byte>(reinterpret_cast<const std::byte*>(values.data()), values.size()));
+  }
+
+  // Writes deflate data by hand, with Huffman codes given most significant bit first as the format requires.
+  struct deflate_writer
+  {
+    std::vector<std::byte> data;
+    std::uint32_t buffer = 0;
+    std::uint32_t bit_count = 0;
+
+    void put_bits(std::uint32_t value, std::uint32_t count)
+    {
+      for (auto i = 0u; i < count; ++i)
+      {
+        buffer |= ((value >> i) & 1) << bit_count;
+
+        if (++bit_count == 8)
+        {
+          data.emplace_back(std::byte(buffer));
+          buffer = 0;
+          bit_count = 0;
+        }
+      }
+    }
+
+    void put_code(std::uint32_t code, std::uint32_t count)
+    {
+      for (auto i = count; i > 0; --i)
+      {
+        put_bits((code >> (i - 1)) & 1, 1);
+      }
+    }
+
+    void flush()
+    {
+      if (bit_count > 0)
+      {
+        put_bits(0, 8 - bit_count);
+      }
+    }
+  };
+
+}// namespace
+
+TEST_CASE("Stored and deflated zip entries are listed in their folders and extracted", "[resources]")
+{
+  const auto folder = make_test_folder("zip-archive");
+
+  const auto readme = std::string(readme_line) + std::string(readme_line) + std::string(readme_line);
+
+  write_file(folder / "content.zip", make_zip({
+    { "readme.txt", 8, to_bytes(readme_deflated), readme.size(), crc_of(readme) },
+    { "data/", 0, {}, 0 },
+    { "data\\abc.txt", 8, to_bytes(abc_deflated), 3, crc_of("abc") },
+    { "data/shapes/box.txt", 0, to_bytes("box"), 3 },
+    { "../outside.txt", 0, to_bytes("no"), 2 },
+  }));
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".zip", std::make_unique<studio::resources::zip::zip_file_archive>());
+
+  const auto root = explorer.get_content_listing(folder / "content.zip");
+  REQUIRE(root.size() == 2);
+  REQUIRE(std::get<studio::resources::folder_info>(root[0]).full_path == folder / "content.zip" / "data");
+  REQUIRE(std::get<studio::resources::file_info>(root[1]).filename == "readme.txt");
+
+  auto files = explorer.find_files({ ".txt" });
+  std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.filename < b.filename; });
+
+  REQUIRE(files.size() == 3);
+  REQUIRE(files[0].folder_path == folder / "content.zip" / "data");
+  REQUIRE(files[0].compression_type == studio::resources::compression_type::deflate);
+  REQUIRE(files[1].folder_path == folder / "content.zip" / "data" / "shapes");
+  REQUIRE(files[1].compression_type == studio::resources::compression_type::none);
+
+  std::vector<std::string> contents;
+
+  for (const auto& file : files)
+  {
+    auto stream = explorer.load_file(file);
+    std::vector<std::byte> data(file.size);
+    stream.second->read(data.data(), std::streamsize(data.size()));
+    contents.emplace_back(to_string(nonstd::span<const std::byte>(data.data(), data.size())));
+  }
+
+  REQUIRE(contents == std::vector<std::string>{ "abc", "box", readme });
+}
+
+TEST_CASE("Invalid deflate data is rejected", "[resources]")
+{
+  std::vector<std::byte> output(16);
+
+  // A final block with the reserved block type.
+  auto reserved_type = to_bytes("\x07");
+  studio::resources::memory_stream reserved_stream({ reserved_type.data(), reserved_type.size() });
+  studio::resources::bounded_reader reserved_reader(reserved_stream, reserved_type.size());
+
+  REQUIRE_THROWS_AS(studio::resources::inflate(reserved_reader, output.data(), output.size()), std::invalid_argument);
+
+  // "abc" doesn't fit into two bytes.
+  auto abc = to_bytes(abc_deflated);
+  studio::resources::memory_stream abc_stream({ abc.data(), abc.size() });
+  studio::resources::bounded_reader abc_reader(abc_stream, abc.size());
+
+  REQUIRE_THROWS_AS(studio::resources::inflate(abc_reader, output.data(), 2), std::invalid_argument);
+}
+
+TEST_CASE("Deflate data which is cut short is rejected", "[resources]")
+{
+  std::vector<std::byte> output(3);
+
+  // Without its last byte, the end of block code of "abc" would only be completed by the zeroes read past the end.
+  auto abc = to_bytes(abc_deflated);
+  studio::resources::memory_stream abc_stream({ abc.data(), abc.size() });
+  studio::resources::bounded_reader abc_reader(abc_stream, abc.size() - 1);
+
+  REQUIRE_THROWS_AS(studio::resources::inflate(abc_reader, output.data(), output.size()), std::invalid_argument);
+}
+
+TEST_CASE("Deflate output is handed over in chunks while matches still reach back a full window", "[resources]")
+{
+  std::vector<std::byte> expected;
+
+  for (auto i = 0u; i < 40000; ++i)
+  {
+    expected.emplace_back(std::byte(i % 251));
+  }
+
+  deflate_writer writer;
+
+  // A stored block which fills more than the window.
+  writer.put_bits(0, 3);
+  writer.flush();
+  writer.put_bits(std::uint32_t(expected.size()), 16);
+  writer.put_bits(~std::uint32_t(expected.size()), 16);
+  writer.data.insert(writer.data.end(), expected.begin(), expected.end());
+
+  // Then a final block with the fixed codes, holding matches of 258 bytes from as far back as deflate allows.
+  writer.put_bits(1, 1);
+  writer.put_bits(1, 2);
+
+  for (auto i = 0; i < 10; ++i)
+  {
+    writer.put_code(0xc5, 8);
+    writer.put_code(29, 5);
+    writer.put_bits(8191, 13);
+
+    for (auto j = 0; j < 258; ++j)
+    {
+      expected.emplace_back(expected[expected.size() - 32768]);
+    }
+  }
+
+  writer.put_code(0, 7);
+  writer.flush();
+
+  studio::resources::memory_stream stream({ writer.data.data(), writer.data.size() });
+  studio::resources::bounded_reader reader(stream, writer.data.size());
+
+  std::vector<std::byte> output;
+  std::size_t chunks = 0;
+
+  const auto produced = studio::resources::inflate(reader, expected.size(), [&](const std::byte* data, std::size_t size) {
+    REQUIRE(size <= 32768);
+    output.insert(output.end(), data, data + size);
+    ++chunks;
+  });
+
+  REQUIRE(produced == expected.size());
+  REQUIRE(chunks == 2);
+  REQUIRE(output == expected);
+}
+
+TEST_CASE("Zip entries are checked against their compressed size and CRC", "[resources]")
+{
+  const auto folder = make_test_folder("zip-archive-checks");
+
+  // Without its last byte, the deflated data of "truncated.txt" runs on into the central directory.
+  auto truncated = to_bytes(abc_deflated);
+  truncated.pop_back();
+
+  write_file(folder / "checks.zip", make_zip({
+    { "good.txt", 8, to_bytes(abc_deflated), 3, crc_of("abc") },
+    { "deflated.txt", 8, to_bytes(abc_deflated), 3, crc_of("abd") },
+    { "stored.txt", 0, to_bytes("box"), 3, crc_of("bot") },
+    { "truncated.txt", 8, truncated, 3, crc_of("abc") },
+    { "oversized.txt", 8, to_bytes(abc_deflated), std::size_t(1) << 30, crc_of("abc") },
+  }));
+
+  studio::resources::resource_explorer explorer(folder);
+  explorer.add_archive_type(".zip", std::make_unique<studio::resources::zip::zip_file_archive>());
+
+  auto files = explorer.find_files({ ".txt" });
+  std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.filename < b.filename; });
+  REQUIRE(files.size() == 5);
+
+  // Stored entries are viewed in place when loaded, so the plugin is used directly to extract them.
+  studio::resources::zip::zip_file_archive archive;
+  const auto mapping = std::make_shared<const studio::resources::mapped_file>(folder / "checks.zip");
+
+  auto extract = [&](const studio::resources::file_info& info) {
+    std::vector<std::byte> data;
+    studio::resources::memory_stream input(mapping->data(), mapping);
+    studio::resources::vector_stream output(data);
+    archive.extract_file_contents(input, info, output);
+    return to_string(nonstd::span<const std::byte>(data.data(), data.size()));
+  };
+
+  REQUIRE_THROWS_AS(extract(files[0]), std::invalid_argument);
+  REQUIRE(extract(files[1]) == "abc");
+
+  // Five bytes of deflate data can't hold a gigabyte, so the listed size is never trusted that far.
+  REQUIRE_THROWS_AS(extract(files[2]), std::invalid_argument);
+  REQUIRE_THROWS_AS(extract(files[3]), std::invalid_argument);
+  REQUIRE_THROWS_AS(extract(files[4]), std::invalid_argument);
+}
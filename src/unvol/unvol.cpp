@@ -1,40 +1,468 @@
-#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <map>
+#include <set>
 #include <algorithm>
-
+#include <iterator>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <memory>
+#include <optional>
+#include <fstream>
 #include <filesystem>
-#include "resources/darkstar_volume.hpp"
+#include "resources/resource_config.hpp"
+#include "resources/bulk_extractor.hpp"
+#include "resources/tar_exporter.hpp"
+#include "resources/duplicate_finder.hpp"
+#include "resources/three_space_checksums.hpp"
+#include "resources/task_pool.hpp"
+#include "shared.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+namespace fs = std::filesystem;
+using clock_type = std::chrono::steady_clock;
+
+struct options
+{
+  std::vector<fs::path> inputs;
+  std::optional<fs::path> output;
+  std::optional<fs::path> tar_output;
+  std::vector<std::string> includes;
+  std::vector<std::string> excludes;
+  std::size_t worker_count = 0;
+  bool list_only = false;
+  bool dry_run = false;
+  bool find_duplicates = false;
+  bool compare_checksums = false;
+};
+
+struct report
+{
+  std::size_t files = 0;
+  std::uint64_t bytes = 0;
+  std::vector<studio::resources::bulk_extractor::failure> failures;
+};
 
-int main(int, const char** argv)
+void print_usage()
 {
-  std::string output_folder(argv[1]);
-  auto volume = std::basic_ifstream<std::byte>{ output_folder, std::ios::binary };
+  std::cerr << "Usage: unvol [options] <archive or folder>...\n"
+            << "  -o, --output <folder>   extract into this folder instead of next to each archive\n"
+            << "  -i, --include <glob>    only extract entries matching the pattern, may be repeated\n"
+            << "  -x, --exclude <glob>    skip entries matching the pattern, may be repeated\n"
+            << "  -j, --jobs <count>      number of worker threads, defaults to one per core\n"
+            << "  -l, --list              list the entries of each archive without extracting them\n"
+            << "  -n, --dry-run           print where entries would be extracted to without writing anything\n"
+            << "  -d, --duplicates        report entries with matching content hashes instead of extracting them\n"
+            << "  -c, --checksums         compare RMF and DYN entries with their checksums as CRC32 instead of extracting them\n"
+            << "  -t, --tar <file>        write the entries into a tar archive instead of extracting them, - for standard output\n";
+}
+
+std::optional<options> parse_options(int argc, const char** argv)
+{
+  options result;
+
+  for (auto i = 1; i < argc; ++i)
+  {
+    const std::string_view arg = argv[i];
+
+    auto next_value = [&]() -> std::optional<std::string_view> {
+      if (i + 1 < argc)
+      {
+        return argv[++i];
+      }
+
+      std::cerr << arg << " expects a value\n";
+      return std::nullopt;
+    };
 
-  auto archive = studio::resources::vol::darkstar::vol_file_archive();
-  auto files = archive.get_content_listing(volume, output_folder);
+    if (arg == "-o" || arg == "--output" || arg == "-i" || arg == "--include" || arg == "-x" || arg == "--exclude" || arg == "-j" || arg == "--jobs" || arg == "-t" || arg == "--tar")
+    {
+      auto value = next_value();
+
+      if (!value.has_value())
+      {
+        return std::nullopt;
+      }
+
+      if (arg == "-o" || arg == "--output")
+      {
+        result.output = fs::path(value.value());
+      }
+      else if (arg == "-i" || arg == "--include")
+      {
+        result.includes.emplace_back(studio::shared::to_lower(value.value()));
+      }
+      else if (arg == "-x" || arg == "--exclude")
+      {
+        result.excludes.emplace_back(studio::shared::to_lower(value.value()));
+      }
+      else if (arg == "-t" || arg == "--tar")
+      {
+        result.tar_output = fs::path(value.value());
+      }
+      else
+      {
+        result.worker_count = std::size_t(std::stoul(std::string(value.value())));
+      }
+    }
+    else if (arg == "-l" || arg == "--list")
+    {
+      result.list_only = true;
+    }
+    else if (arg == "-n" || arg == "--dry-run")
+    {
+      result.dry_run = true;
+    }
+    else if (arg == "-d" || arg == "--duplicates")
+    {
+      result.find_duplicates = true;
+    }
+    else if (arg == "-c" || arg == "--checksums")
+    {
+      result.compare_checksums = true;
+    }
+    else if (arg == "-h" || arg == "--help")
+    {
+      return std::nullopt;
+    }
+    else if (arg.size() > 1 && arg.front() == '-')
+    {
+      std::cerr << "Unknown option " << arg << '\n';
+      return std::nullopt;
+    }
+    else
+    {
+      result.inputs.emplace_back(fs::weakly_canonical(fs::absolute(fs::path(arg))));
+    }
+  }
 
-  if (auto index = output_folder.find(".vol"); index != std::string::npos)
+  if (result.inputs.empty())
   {
-    output_folder.replace(index, 4, "");
+    return std::nullopt;
   }
 
-  if (auto index = output_folder.find(".VOL"); index != std::string::npos)
+  return result;
+}
+
+// Matches a lower case pattern where * is any number of characters and ? is exactly one.
+bool matches_glob(std::string_view pattern, std::string_view value)
+{
+  std::size_t pattern_index = 0;
+  std::size_t value_index = 0;
+  std::optional<std::size_t> star_index;
+  std::size_t star_value_index = 0;
+
+  while (value_index < value.size())
   {
-    output_folder.replace(index, 4, "");
+    if (pattern_index < pattern.size() && (pattern[pattern_index] == '?' || pattern[pattern_index] == value[value_index]))
+    {
+      pattern_index++;
+      value_index++;
+    }
+    else if (pattern_index < pattern.size() && pattern[pattern_index] == '*')
+    {
+      star_index = pattern_index++;
+      star_value_index = value_index;
+    }
+    else if (star_index.has_value())
+    {
+      pattern_index = star_index.value() + 1;
+      value_index = ++star_value_index;
+    }
+    else
+    {
+      return false;
+    }
   }
 
-  for (auto& some_file : files)
+  while (pattern_index < pattern.size() && pattern[pattern_index] == '*')
   {
-    std::visit([&](auto& info) {
-           using info_type = std::decay_t<decltype(info)>;
+    pattern_index++;
+  }
+
+  return pattern_index == pattern.size();
+}
+
+bool is_selected(const options& settings, const std::string& entry_path)
+{
+  auto matches_any = [&](const auto& patterns) {
+    return std::any_of(patterns.begin(), patterns.end(), [&](const auto& pattern) { return matches_glob(pattern, entry_path); });
+  };
+
+  return (settings.includes.empty() || matches_any(settings.includes)) && !matches_any(settings.excludes);
+}
+
+// Archives are grouped by the folder they are found in, which becomes the search path of their explorer.
+// For folders given on the command line, the folder itself is used, so that extracted files keep their sub folders.
+// Archives found through more than one input are only used once.
+std::map<fs::path, std::vector<fs::path>> find_archives(const options& settings, report& totals)
+{
+  std::map<fs::path, std::vector<fs::path>> results;
+  std::set<fs::path> found;
+
+  for (const auto& input : settings.inputs)
+  {
+    if (fs::is_directory(input))
+    {
+      auto explorer = studio::resources::create_default_resource_explorer(input);
+      auto& archives = results[input];
+
+      for (const auto& item : fs::recursive_directory_iterator(input))
+      {
+        if (item.is_regular_file() && explorer.get_archive_type(item.path()).has_value() && found.insert(item.path()).second)
+        {
+          archives.emplace_back(item.path());
+        }
+      }
+    }
+    else if (fs::exists(input))
+    {
+      if (found.insert(input).second)
+      {
+        results[input.parent_path()].emplace_back(input);
+      }
+    }
+    else
+    {
+      totals.failures.push_back({ input, "does not exist" });
+    }
+  }
+
+  return results;
+}
+
+int main(int argc, const char** argv)
+{
+  auto settings = parse_options(argc, argv);
+
+  if (!settings.has_value())
+  {
+    print_usage();
+    return 1;
+  }
+
+  auto own_pool = settings->worker_count > 0 ? std::make_unique<studio::resources::task_pool>(settings->worker_count) : nullptr;
+  auto& pool = own_pool ? *own_pool : studio::resources::task_pool::shared();
+
+  const auto start = clock_type::now();
+  report totals;
+
+  // The archive goes to standard output when asked to, so everything else has to go to standard error then.
+  const auto tar_to_stdout = settings->tar_output.has_value() && settings->tar_output.value() == "-";
+  auto& messages = tar_to_stdout ? std::cerr : std::cout;
+
+  std::ofstream tar_file;
+  std::unique_ptr<studio::resources::tar_exporter> exporter;
+
+  if (tar_to_stdout)
+  {
+#ifdef _WIN32
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    exporter = std::make_unique<studio::resources::tar_exporter>(std::cout);
+  }
+  else if (settings->tar_output.has_value())
+  {
+    tar_file.open(settings->tar_output.value(), std::ios::binary);
+
+    if (!tar_file)
+    {
+      std::cerr << "Could not open " << settings->tar_output->string() << '\n';
+      return 1;
+    }
 
-           if constexpr (std::is_same_v<info_type, studio::resources::file_info>)
-           {
-             auto final_folder = output_folder / std::filesystem::relative(info.folder_path, output_folder);
-             std::filesystem::create_directories(final_folder);
-             auto filename = final_folder / info.filename;
-             auto new_stream = std::basic_ofstream<std::byte>{ filename, std::ios::binary };
-             archive.extract_file_contents(volume, info, new_stream);
-           }
-    }, some_file);
+    exporter = std::make_unique<studio::resources::tar_exporter>(tar_file);
   }
-}
\ No newline at end of file
+
+  auto groups = find_archives(settings.value(), totals);
+  studio::resources::duplicate_finder duplicates(pool);
+
+  if (settings->compare_checksums)
+  {
+    std::vector<fs::path> archive_paths;
+
+    for (const auto& group : groups)
+    {
+      archive_paths.insert(archive_paths.end(), group.second.begin(), group.second.end());
+    }
+
+    auto result = studio::resources::vol::three_space::compare_checksums(archive_paths, pool);
+
+    for (const auto& mismatch : result.mismatches)
+    {
+      std::cout << (mismatch.volume_path / mismatch.info.filename).string() << std::hex
+                << ": expected " << mismatch.expected << ", found " << mismatch.actual << std::dec << '\n';
+    }
+
+    // The algorithm behind the checksums isn't confirmed, so differences aren't reported as damage.
+    std::cout << result.mismatches.size() << " entries differ from their checksums (compared as CRC32, algorithm unconfirmed)\n";
+
+    totals.files += result.files_checked;
+    totals.bytes += result.bytes_checked;
+
+    for (auto& failure : result.failures)
+    {
+      totals.failures.push_back({ std::move(failure.first), std::move(failure.second) });
+    }
+
+    // Nothing is extracted when comparing checksums.
+    groups.clear();
+  }
+
+  for (const auto& [search_path, archives] : groups)
+  {
+    auto explorer = studio::resources::create_default_resource_explorer(search_path);
+    const auto destination = settings->output.value_or(search_path);
+
+    std::vector<studio::resources::file_info> entries;
+
+    for (const auto& archive_path : archives)
+    {
+      try
+      {
+        for (auto& entry : explorer.find_files(archive_path, { "ALL" }))
+        {
+          const auto entry_path = (fs::relative(entry.folder_path, archive_path) / entry.filename).lexically_normal();
+
+          if (!is_selected(settings.value(), studio::shared::to_lower(entry_path.generic_string())))
+          {
+            continue;
+          }
+
+          if (settings->list_only)
+          {
+            std::cout << (archive_path / entry_path).string() << '\t' << entry.size << '\n';
+            totals.files++;
+            totals.bytes += entry.size;
+          }
+          else if (settings->dry_run)
+          {
+            std::cout << (explorer.get_extraction_folder(destination, entry) / entry.filename).lexically_normal().string() << '\n';
+            totals.files++;
+            totals.bytes += entry.size;
+          }
+          else
+          {
+            entries.emplace_back(std::move(entry));
+          }
+        }
+      }
+      catch (const std::exception& ex)
+      {
+        totals.failures.push_back({ archive_path, ex.what() });
+      }
+    }
+
+    if (entries.empty())
+    {
+      continue;
+    }
+
+    if (settings->find_duplicates)
+    {
+      duplicates.add_entries(explorer, entries);
+      continue;
+    }
+
+    if (exporter)
+    {
+      try
+      {
+        auto result = exporter->write(explorer, entries);
+        totals.files += result.files_written;
+        totals.bytes += result.bytes_written;
+
+        for (auto& failure : result.failures)
+        {
+          totals.failures.push_back({ std::move(failure.path), std::move(failure.message) });
+        }
+      }
+      catch (const std::exception& ex)
+      {
+        totals.failures.push_back({ search_path, ex.what() });
+      }
+
+      continue;
+    }
+
+    studio::resources::bulk_extractor extractor(explorer, studio::resources::bulk_extractor::default_in_flight_budget, pool);
+
+    std::mutex progress_mutex;
+    std::atomic_size_t done = 0;
+    const auto total = entries.size();
+    const auto label = search_path.string();
+
+    extractor.set_progress_callback([&](const auto&) {
+      const auto count = ++done;
+
+      if (count % 256 == 0 || count == total)
+      {
+        std::lock_guard<std::mutex> lock(progress_mutex);
+        std::cerr << '\r' << label << ' ' << count << '/' << total << std::flush;
+      }
+    });
+
+    auto result = extractor.extract(entries, destination);
+    std::cerr << '\n';
+
+    totals.files += result.files_written;
+    totals.bytes += result.bytes_written;
+    std::move(result.failures.begin(), result.failures.end(), std::back_inserter(totals.failures));
+  }
+
+  if (exporter)
+  {
+    exporter->finish();
+    std::cout.flush();
+    tar_file.close();
+  }
+
+  if (settings->find_duplicates)
+  {
+    auto result = duplicates.get_report();
+
+    for (const auto& group : result.groups)
+    {
+      std::cout << group.entries.size() << " hash matches of " << group.size << " bytes, " << group.get_redundant_bytes() << " likely redundant\n";
+
+      for (const auto& entry : group.entries)
+      {
+        std::cout << '\t' << (entry.folder_path / entry.filename).string() << '\n';
+      }
+    }
+
+    std::cout << result.groups.size() << " groups of matching hashes, " << result.redundant_bytes << " bytes could be saved if they are duplicates\n";
+
+    totals.files += result.files_hashed;
+    totals.bytes += result.bytes_hashed;
+
+    for (auto& failure : result.failures)
+    {
+      totals.failures.push_back({ std::move(failure.path), std::move(failure.message) });
+    }
+  }
+
+  const auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+  const auto megabytes = double(totals.bytes) / (1024 * 1024);
+
+  for (const auto& failure : totals.failures)
+  {
+    std::cerr << failure.path.string() << ": " << failure.message << '\n';
+  }
+
+  messages << (settings->list_only ? "listed " : settings->dry_run ? "would extract " : settings->find_duplicates ? "hashed " : settings->compare_checksums ? "compared " : exporter ? "archived " : "extracted ")
+            << totals.files << " files, "
+            << totals.bytes << " bytes in "
+            << std::fixed << std::setprecision(3) << seconds << "s ("
+            << std::setprecision(2) << (seconds > 0 ? megabytes / seconds : 0.0) << " MB/s), "
+            << totals.failures.size() << " failures\n";
+
+  return totals.failures.empty() ? 0 : 1;
+}
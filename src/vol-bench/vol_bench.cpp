@@ -0,0 +1,163 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <map>
+#include <vector>
+#include <filesystem>
+#include "resources/resource_explorer.hpp"
+#include "resources/resource_config.hpp"
+
+namespace fs = std::filesystem;
+using clock_type = std::chrono::steady_clock;
+
+// Discards everything written to it, only keeping count of the bytes.
+struct counting_buffer : public std::basic_streambuf<std::byte>
+{
+  std::size_t count = 0;
+
+  int_type overflow(int_type c) override
+  {
+    count++;
+    return c;
+  }
+
+  std::streamsize xsputn(const std::byte*, std::streamsize size) override
+  {
+    count += std::size_t(size);
+    return size;
+  }
+};
+
+struct timing
+{
+  std::size_t files = 0;
+  std::size_t bytes = 0;
+  clock_type::duration time{};
+};
+
+void print_row(std::string_view name, const timing& result)
+{
+  const auto seconds = std::chrono::duration<double>(result.time).count();
+  const auto megabytes = double(result.bytes) / (1024 * 1024);
+
+  std::cout << std::setw(12) << name
+            << std::setw(10) << result.files
+            << std::setw(16) << result.bytes
+            << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+            << std::setw(12) << std::fixed << std::setprecision(2) << (seconds > 0 ? megabytes / seconds : 0.0)
+            << '\n';
+}
+
+int main(int argc, const char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: vol-bench [--mmap] <volume>...\n";
+    return 1;
+  }
+
+  auto use_mapping = false;
+
+  const static std::map<studio::resources::compression_type, std::string_view> type_names{
+    { studio::resources::compression_type::none, "copy" },
+    { studio::resources::compression_type::rle, "rle" },
+    { studio::resources::compression_type::lz, "lz" },
+    { studio::resources::compression_type::lzh, "lzh" },
+    { studio::resources::compression_type::deflate, "deflate" }
+  };
+
+  for (auto i = 1; i < argc; ++i)
+  {
+    if (argv[i] == std::string_view("--mmap"))
+    {
+      use_mapping = true;
+      continue;
+    }
+
+    const auto volume_path = fs::absolute(argv[i]);
+    const auto search_path = volume_path.parent_path();
+
+    auto explorer = studio::resources::create_default_resource_explorer(search_path);
+    explorer.use_memory_mapping(use_mapping);
+
+    try
+    {
+      timing raw_read{};
+      {
+        std::vector<std::byte> buffer(1024 * 1024);
+        studio::resources::shared_file volume(volume_path);
+
+        const auto start = clock_type::now();
+        while (auto count = volume.read_at(raw_read.bytes, buffer.data(), buffer.size()))
+        {
+          raw_read.bytes += count;
+        }
+        raw_read.time = clock_type::now() - start;
+        raw_read.files = 1;
+      }
+
+      const auto listing_start = clock_type::now();
+      const auto files = explorer.find_files(volume_path, { "ALL" });
+      timing listing{ files.size(), 0, clock_type::now() - listing_start };
+
+      std::map<studio::resources::compression_type, timing> results;
+
+      for (const auto& file : files)
+      {
+        const auto archive_path = studio::resources::resource_explorer::get_archive_path(file.folder_path);
+        auto archive = explorer.get_archive_type(archive_path);
+
+        if (!archive.has_value())
+        {
+          continue;
+        }
+
+        counting_buffer sink;
+        std::basic_ostream<std::byte> output(&sink);
+
+        const auto start = clock_type::now();
+
+        // Only stored entries are read through views, otherwise the pass would measure the decoded entry cache.
+        if (auto view = use_mapping && file.compression_type == studio::resources::compression_type::none ? explorer.load_file_view(file) : std::nullopt; view.has_value())
+        {
+          output.write(view->data.data(), std::streamsize(view->data.size()));
+        }
+        else
+        {
+          auto archive_file = explorer.load_file(archive_path);
+          archive->get().extract_file_contents(*archive_file.second, file, output);
+        }
+
+        auto& result = results[file.compression_type];
+        result.time += clock_type::now() - start;
+        result.bytes += sink.count;
+        result.files++;
+      }
+
+      std::cout << volume_path.string() << '\n';
+      std::cout << std::setw(12) << "pass" << std::setw(10) << "files" << std::setw(16) << "bytes"
+                << std::setw(12) << "seconds" << std::setw(12) << "MB/s" << '\n';
+
+      print_row("read", raw_read);
+      print_row("listing", listing);
+
+      timing total{};
+      for (const auto& [type, result] : results)
+      {
+        print_row(type_names.at(type), result);
+        total.files += result.files;
+        total.bytes += result.bytes;
+        total.time += result.time;
+      }
+
+      print_row("total", total);
+      std::cout << '\n';
+    }
+    catch (const std::exception& ex)
+    {
+      std::cerr << volume_path.string() << " " << ex.what() << '\n';
+    }
+  }
+
+  return 0;
+}